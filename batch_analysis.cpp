@@ -0,0 +1,391 @@
+#include "batch_analysis.h"
+#include <sstream>
+#include <deque>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+
+namespace {
+
+// One value of a flat JSON object: the raw token as written, and for strings
+// the decoded text
+struct JsonField
+{
+    std::string raw;
+    std::string text;
+    bool isString = false;
+};
+
+void skipSpace(const std::string& s, size_t& pos) {
+    while (pos < s.size() && std::isspace(static_cast<unsigned char>(s[pos]))) pos++;
+}
+
+bool readString(const std::string& s, size_t& pos, std::string& out) {
+    if (pos >= s.size() || s[pos] != '"') return false;
+    pos++;
+    out.clear();
+    while (pos < s.size()) {
+        char c = s[pos++];
+        if (c == '"') return true;
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (pos >= s.size()) return false;
+        char escaped = s[pos++];
+        switch (escaped) {
+            case '"': case '\\': case '/': out += escaped; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                if (pos + 4 > s.size()) return false;
+                unsigned code = static_cast<unsigned>(std::strtoul(s.substr(pos, 4).c_str(), nullptr, 16));
+                pos += 4;
+                if (code < 0x80) {
+                    out += static_cast<char>(code);
+                } else if (code < 0x800) {
+                    out += static_cast<char>(0xC0 | (code >> 6));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                } else {
+                    out += static_cast<char>(0xE0 | (code >> 12));
+                    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default: return false;
+        }
+    }
+    return false;
+}
+
+// Skip over one value of any kind, nested objects and arrays included
+bool skipValue(const std::string& s, size_t& pos) {
+    std::string ignored;
+    if (pos >= s.size()) return false;
+    if (s[pos] == '"') return readString(s, pos, ignored);
+
+    if (s[pos] == '{' || s[pos] == '[') {
+        int depth = 0;
+        while (pos < s.size()) {
+            char c = s[pos];
+            if (c == '"') {
+                if (!readString(s, pos, ignored)) return false;
+                continue;
+            }
+            if (c == '{' || c == '[') depth++;
+            if (c == '}' || c == ']') depth--;
+            pos++;
+            if (depth == 0) return true;
+        }
+        return false;
+    }
+
+    size_t start = pos;
+    while (pos < s.size() && s[pos] != ',' && s[pos] != '}' && s[pos] != ']' &&
+           !std::isspace(static_cast<unsigned char>(s[pos]))) {
+        pos++;
+    }
+    return pos > start;
+}
+
+// Just enough JSON for the batch format: one object per line whose fields of
+// interest are strings or numbers
+bool parseObject(const std::string& s, std::map<std::string, JsonField>& fields) {
+    size_t pos = 0;
+    skipSpace(s, pos);
+    if (pos >= s.size() || s[pos] != '{') return false;
+    pos++;
+
+    skipSpace(s, pos);
+    if (pos < s.size() && s[pos] == '}') return true;
+
+    while (pos < s.size()) {
+        std::string name;
+        skipSpace(s, pos);
+        if (!readString(s, pos, name)) return false;
+        skipSpace(s, pos);
+        if (pos >= s.size() || s[pos] != ':') return false;
+        pos++;
+        skipSpace(s, pos);
+
+        JsonField field;
+        size_t start = pos;
+        if (pos < s.size() && s[pos] == '"') {
+            if (!readString(s, pos, field.text)) return false;
+            field.isString = true;
+        } else if (!skipValue(s, pos)) {
+            return false;
+        }
+        field.raw = s.substr(start, pos - start);
+        fields[name] = field;
+
+        skipSpace(s, pos);
+        if (pos >= s.size()) return false;
+        if (s[pos] == '}') return true;
+        if (s[pos] != ',') return false;
+        pos++;
+    }
+    return false;
+}
+
+bool readNumber(const JsonField& field, long& value) {
+    if (field.isString || field.raw.empty()) return false;
+    char* end = nullptr;
+    value = std::strtol(field.raw.c_str(), &end, 10);
+    return end && *end == '\0';
+}
+
+std::string escapeJson(const std::string& str) {
+    std::string out;
+    for (char c : str) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+std::string errorLine(const std::string& id, const std::string& message) {
+    std::string out = "{";
+    if (!id.empty()) out += "\"id\":" + id + ",";
+    out += "\"error\":\"" + escapeJson(message) + "\"}";
+    return out;
+}
+
+std::string resultLine(const std::string& id, const std::string& fen, const CachedResult& result,
+                       long nodes, long timeMs, bool cached) {
+    std::ostringstream out;
+    out << "{";
+    if (!id.empty()) out << "\"id\":" << id << ",";
+    out << "\"fen\":\"" << escapeJson(fen) << "\",";
+
+    // No legal moves: checkmate or stalemate
+    if (result.move.isNull()) {
+        out << "\"move\":null,\"eval\":0,\"depth\":0";
+    } else {
+        out << "\"move\":\"" << result.move.toString() << "\""
+            << ",\"eval\":" << result.eval
+            << ",\"depth\":" << result.depth;
+    }
+    out << ",\"nodes\":" << nodes
+        << ",\"timeMs\":" << timeMs
+        << ",\"pv\":[";
+    for (size_t i = 0; i < result.pv.size(); i++) {
+        if (i > 0) out << ",";
+        out << "\"" << result.pv[i].toString() << "\"";
+    }
+    out << "]";
+    if (cached) out << ",\"cached\":true";
+    out << "}";
+    return out.str();
+}
+
+std::string trim(const std::string& s) {
+    size_t start = 0;
+    size_t end = s.size();
+    while (start < end && std::isspace(static_cast<unsigned char>(s[start]))) start++;
+    while (end > start && std::isspace(static_cast<unsigned char>(s[end - 1]))) end--;
+    return s.substr(start, end - start);
+}
+
+} // namespace
+
+BatchAnalyzer::BatchAnalyzer(EnginePool& p, const Options& opts) : pool(p), options(opts) {
+    if (options.maxDepth > MAX_PLY - 1) options.maxDepth = MAX_PLY - 1;
+    if (options.maxDepth < 1) options.maxDepth = 1;
+}
+
+std::string BatchAnalyzer::analyzeLine(const std::string& line) {
+    std::string id;
+    std::string fen;
+    long depth = 0;
+    long nodes = options.defaultNodes;
+
+    if (line[0] == '{') {
+        std::map<std::string, JsonField> fields;
+        if (!parseObject(line, fields)) {
+            return errorLine("", "Invalid JSON");
+        }
+        auto field = fields.find("id");
+        if (field != fields.end()) id = field->second.raw;
+
+        field = fields.find("fen");
+        if (field == fields.end() || !field->second.isString) {
+            return errorLine(id, "Missing fen");
+        }
+        fen = trim(field->second.text);
+
+        field = fields.find("depth");
+        if (field != fields.end() && (!readNumber(field->second, depth) || depth < 1)) {
+            return errorLine(id, "depth must be a positive integer");
+        }
+        field = fields.find("nodes");
+        if (field != fields.end() && (!readNumber(field->second, nodes) || nodes < 1)) {
+            return errorLine(id, "nodes must be a positive integer");
+        }
+    } else {
+        fen = line;
+    }
+
+    // A node budget without a depth searches as deep as the budget allows
+    if (depth == 0) depth = nodes > 0 ? options.maxDepth : options.defaultDepth;
+    depth = std::min<long>(depth, options.maxDepth);
+
+    std::string error;
+    uint64_t key = 0;
+    bool useCache = options.cache && options.cache->enabled() && nodes == 0;
+    if (useCache) {
+        Board board;
+        board.setupFromFEN(fen);
+        if (!EnginePool::checkPosition(board, fen, error)) {
+            return errorLine(id, error);
+        }
+        key = board.getHashKey();
+
+        CachedResult cached;
+        if (options.cache->lookup(key, static_cast<int>(depth), cached)) {
+            return resultLine(id, fen, cached, 0, 0, true);
+        }
+    }
+
+    EnginePool::Lease lease = pool.acquire();
+
+    if (!lease.setPosition(fen, error)) {
+        return errorLine(id, error);
+    }
+
+    Engine& engine = lease.engine();
+    engine.setDepth(static_cast<int>(depth));
+    engine.setNodeLimit(nodes);
+    // The listener runs inside the search, so an abandoned batch stops it there
+    engine.setSearchListener([this, &engine](const SearchInfo&) {
+        if (!abandoned.load() && options.cancelled && options.cancelled()) {
+            abandoned.store(true);
+        }
+        if (abandoned.load()) {
+            engine.stop();
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    Move bestMove = engine.getBestMove();
+    long timeMs = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    CachedResult result = CachedResult::fromSearch(engine, bestMove);
+    if (useCache) {
+        options.cache->store(key, result);
+    }
+    return resultLine(id, fen, result, engine.getNodesSearched(), timeMs, false);
+}
+
+size_t BatchAnalyzer::run(std::istream& input, std::ostream& output) {
+    return run(input, [&output](const std::string& line) {
+        output << line << '\n';
+        output.flush();
+        return static_cast<bool>(output);
+    });
+}
+
+size_t BatchAnalyzer::run(std::istream& input, const LineSink& sink) {
+    abandoned.store(false);
+    int threadCount = options.threads > 0 ? options.threads : pool.size();
+
+    // Lines are read at most this far ahead of the output, so a slow position
+    // holds back a bounded number of finished results rather than the whole file
+    const size_t window = static_cast<size_t>(threadCount) * 4;
+
+    struct Job
+    {
+        size_t index;
+        std::string line;
+    };
+
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable resultWritten;
+    std::deque<Job> jobs;
+    std::map<size_t, std::string> finished; // Results waiting for earlier lines
+    size_t nextToWrite = 0;
+    bool inputDone = false;
+
+    auto worker = [&]() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobAvailable.wait(lock, [&] { return !jobs.empty() || inputDone; });
+                if (jobs.empty() || abandoned.load()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            std::string result = analyzeLine(job.line);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished[job.index] = std::move(result);
+                // Write everything that now follows on from what is already out
+                while (!abandoned.load() && !finished.empty() && finished.begin()->first == nextToWrite) {
+                    if (!sink(finished.begin()->second)) {
+                        abandoned.store(true);
+                        jobs.clear();
+                        break;
+                    }
+                    finished.erase(finished.begin());
+                    nextToWrite++;
+                }
+            }
+            resultWritten.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+
+    std::string line;
+    size_t index = 0;
+    while (!abandoned.load() && std::getline(input, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        resultWritten.wait(lock, [&] { return index - nextToWrite < window || abandoned.load(); });
+        if (abandoned.load()) break;
+        jobs.push_back(Job{index++, line});
+        lock.unlock();
+        jobAvailable.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        inputDone = true;
+    }
+    jobAvailable.notify_all();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return nextToWrite;
+}
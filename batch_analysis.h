@@ -0,0 +1,63 @@
+#ifndef BATCH_ANALYSIS_H
+#define BATCH_ANALYSIS_H
+
+#include "engine_pool.h"
+#include "result_cache.h"
+#include <iostream>
+#include <atomic>
+#include <functional>
+
+// Bulk analysis of positions read as JSON lines, one position per line:
+//
+//   {"id": 7, "fen": "<fen>", "depth": 8}
+//   {"fen": "<fen>", "nodes": 200000}
+//   <a bare FEN>
+//
+// Lines are spread over the engines of an EnginePool, and one result line is
+// written per input line, in input order, as soon as it and every line before
+// it are done:
+//
+//   {"id":7,"fen":"...","move":"e2e4","eval":35,"depth":8,"nodes":51234,"timeMs":42,"pv":["e2e4","e7e5"]}
+//
+// eval is in centipawns from white's point of view, as on /move, and depth is
+// the deepest iteration that completed. A line that cannot be analyzed gives
+// {"id":...,"error":"..."}. Blank lines and lines starting with '#' are skipped.
+// With a result cache, depth-limited lines already answered deeply enough are
+// not searched again; their results carry "cached":true.
+class BatchAnalyzer
+{
+public:
+    struct Options
+    {
+        int defaultDepth = 6; // For lines with neither depth nor nodes
+        long defaultNodes = 0; // Node budget for lines without one (0 = none)
+        int maxDepth = 12;    // Depths are clamped to this; also the depth of node-limited lines
+        int threads = 0;      // Positions searched at once (0 = one per pool engine)
+        ResultCache *cache = nullptr; // Optional; node-limited lines bypass it
+        std::function<bool()> cancelled; // Optional; polled during searches, true abandons the batch
+    };
+
+    // Takes one result line (without newline); false abandons the batch
+    typedef std::function<bool(const std::string &line)> LineSink;
+
+    BatchAnalyzer(EnginePool &pool, const Options &options);
+
+    // Analyze every line of input and write the results to output.
+    // Returns the number of result lines written.
+    size_t run(std::istream &input, std::ostream &output);
+
+    // As above, handing each result line to sink as soon as it is due. Once
+    // sink returns false (or Options::cancelled returns true) no more lines
+    // are read or started and the searches in progress are stopped.
+    size_t run(std::istream &input, const LineSink &sink);
+
+    // Analyze a single input line and return its result line
+    std::string analyzeLine(const std::string &line);
+
+private:
+    EnginePool &pool;
+    Options options;
+    std::atomic<bool> abandoned{false}; // Set when run's sink refuses a line or the batch is cancelled
+};
+
+#endif // BATCH_ANALYSIS_H
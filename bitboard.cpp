@@ -0,0 +1,206 @@
+#include "bitboard.h"
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BITBOARD_X86_MSVC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BITBOARD_X86_GCC 1
+#endif
+
+namespace Bitboards {
+
+namespace detail {
+
+SliderMagic bishopMagics[64];
+SliderMagic rookMagics[64];
+
+} // namespace detail
+
+namespace {
+
+constexpr int BISHOP_DIRECTIONS[4][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+constexpr int ROOK_DIRECTIONS[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+// Walk each ray until the board edge or the first blocker (inclusive)
+constexpr Bitboard slidingAttacks(int square, Bitboard occupied, const int (*directions)[2]) {
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; d++) {
+        int row = (square >> 3) + directions[d][0];
+        int col = (square & 7) + directions[d][1];
+        while (row >= 0 && row < 8 && col >= 0 && col < 8) {
+            Bitboard target = 1ULL << (row * 8 + col);
+            attacks |= target;
+            if (occupied & target) break;
+            row += directions[d][0];
+            col += directions[d][1];
+        }
+    }
+    return attacks;
+}
+
+constexpr std::array<std::array<Bitboard, 64>, 64> makeBetweenTable() {
+    std::array<std::array<Bitboard, 64>, 64> table{};
+    for (int from = 0; from < 64; from++) {
+        for (int to = 0; to < 64; to++) {
+            int rowDiff = (to >> 3) - (from >> 3);
+            int colDiff = (to & 7) - (from & 7);
+            bool aligned = (rowDiff == 0 || colDiff == 0 || rowDiff == colDiff || rowDiff == -colDiff);
+            if (from == to || !aligned) continue;
+
+            int rowDir = (rowDiff > 0) - (rowDiff < 0);
+            int colDir = (colDiff > 0) - (colDiff < 0);
+            int row = (from >> 3) + rowDir;
+            int col = (from & 7) + colDir;
+            Bitboard squares = 0;
+            while (row * 8 + col != to) {
+                squares |= 1ULL << (row * 8 + col);
+                row += rowDir;
+                col += colDir;
+            }
+            table[from][to] = squares;
+        }
+    }
+    return table;
+}
+
+constexpr std::array<std::array<Bitboard, 64>, 64> makeLineTable() {
+    std::array<std::array<Bitboard, 64>, 64> table{};
+    for (int a = 0; a < 64; a++) {
+        for (int b = 0; b < 64; b++) {
+            if (a == b) continue;
+            Bitboard ends = (1ULL << a) | (1ULL << b);
+            if ((a >> 3) == (b >> 3) || (a & 7) == (b & 7)) {
+                table[a][b] = (slidingAttacks(a, 0, ROOK_DIRECTIONS) & slidingAttacks(b, 0, ROOK_DIRECTIONS)) | ends;
+            } else if (slidingAttacks(a, 0, BISHOP_DIRECTIONS) & (1ULL << b)) {
+                table[a][b] = (slidingAttacks(a, 0, BISHOP_DIRECTIONS) & slidingAttacks(b, 0, BISHOP_DIRECTIONS)) | ends;
+            }
+        }
+    }
+    return table;
+}
+
+constexpr std::array<std::array<Bitboard, 64>, 64> BETWEEN = makeBetweenTable();
+constexpr std::array<std::array<Bitboard, 64>, 64> LINE = makeLineTable();
+
+// Attack storage: sum over squares of 2^(relevant bits)
+Bitboard bishopTable[0x1480];
+Bitboard rookTable[0x19000];
+
+bool cpuHasBmi2() {
+#if defined(BITBOARD_X86_GCC)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2");
+#elif defined(BITBOARD_X86_MSVC)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+// Fixed-seed xorshift64* generator so the magics are identical on every run
+class MagicRng {
+public:
+    explicit MagicRng(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 2685821657736338717ULL;
+    }
+    uint64_t sparse() { return next() & next() & next(); }
+private:
+    uint64_t state;
+};
+
+// Fill one piece type's magic entries and attack table. For each square,
+// enumerate every subset of the relevant mask (Carry-Rippler), and either
+// store by PEXT index or search for a magic that maps subsets without
+// destructive collisions.
+void initSliders(detail::SliderMagic* magics, Bitboard* table, const int (*directions)[2]) {
+    Bitboard occupancy[4096];
+    Bitboard reference[4096];
+    int epoch[4096] = {0};
+    int attempt = 0;
+    Bitboard* next = table;
+
+    // Per-rank seeds known to converge quickly for this generator
+    static const uint64_t seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+
+    for (int square = 0; square < 64; square++) {
+        Bitboard edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (8 * rowOf(square)))) |
+                         ((FILE_A | FILE_H) & ~(FILE_A << colOf(square)));
+
+        detail::SliderMagic& m = magics[square];
+        m.mask = slidingAttacks(square, 0, directions) & ~edges;
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = next;
+
+        int size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancy[size] = subset;
+            reference[size] = slidingAttacks(square, subset, directions);
+            size++;
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+        next += size;
+
+        if (usingPext()) {
+            m.magic = 0;
+            for (int i = 0; i < size; i++) {
+                m.attacks[detail::sliderIndex(m, occupancy[i])] = reference[i];
+            }
+            continue;
+        }
+
+        MagicRng rng(seeds[rowOf(square)]);
+        for (int i = 0; i < size;) {
+            do {
+                m.magic = rng.sparse();
+            } while (popCount((m.magic * m.mask) >> 56) < 6);
+
+            attempt++;
+            for (i = 0; i < size; i++) {
+                unsigned index = static_cast<unsigned>((occupancy[i] * m.magic) >> m.shift);
+                if (epoch[index] < attempt) {
+                    epoch[index] = attempt;
+                    m.attacks[index] = reference[i];
+                } else if (m.attacks[index] != reference[i]) {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+void init() {
+    static std::once_flag initialized;
+    std::call_once(initialized, []() {
+        // A PEXT build would die on its first lookup with an illegal instruction
+        if (usingPext() && !cpuHasBmi2()) {
+            std::cerr << "Error: this build uses BMI2 (USE_PEXT) but the CPU does not support it" << std::endl;
+            std::abort();
+        }
+        initSliders(detail::bishopMagics, bishopTable, BISHOP_DIRECTIONS);
+        initSliders(detail::rookMagics, rookTable, ROOK_DIRECTIONS);
+    });
+}
+
+Bitboard between(int from, int to) {
+    return BETWEEN[from][to];
+}
+
+Bitboard line(int a, int b) {
+    return LINE[a][b];
+}
+
+} // namespace Bitboards
@@ -0,0 +1,176 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "piece.h"
+#include <array>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Slider lookups use the BMI2 PEXT instruction when the build targets it
+// (CMake option USE_PEXT), else magic multiplication. The choice is made at
+// build time so that every lookup inlines to a few instructions.
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define BITBOARD_USE_PEXT 1
+#endif
+
+// 64-bit set of squares. Bit index = row * 8 + col (a1 = 0, h1 = 7, a8 = 56, h8 = 63)
+typedef uint64_t Bitboard;
+
+namespace Bitboards {
+
+static const Bitboard EMPTY = 0ULL;
+static const Bitboard FILE_A = 0x0101010101010101ULL;
+static const Bitboard FILE_H = FILE_A << 7;
+static const Bitboard RANK_1 = 0xFFULL;
+static const Bitboard RANK_2 = RANK_1 << 8;
+static const Bitboard RANK_3 = RANK_1 << 16;
+static const Bitboard RANK_6 = RANK_1 << 40;
+static const Bitboard RANK_7 = RANK_1 << 48;
+static const Bitboard RANK_8 = RANK_1 << 56;
+
+// Square <-> Position conversion
+inline int toSquare(const Position& pos) { return pos.row * 8 + pos.col; }
+inline Position fromSquare(int square) { return Position(square >> 3, square & 7); }
+inline Bitboard squareBB(int square) { return 1ULL << square; }
+inline int rowOf(int square) { return square >> 3; }
+inline int colOf(int square) { return square & 7; }
+
+// Bit twiddling helpers
+inline int popCount(Bitboard b) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(b));
+#else
+    return __builtin_popcountll(b);
+#endif
+}
+
+// Index of the least significant set bit (b must be non-zero)
+inline int lsb(Bitboard b) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, b);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(b);
+#endif
+}
+
+// Remove and return the least significant set bit
+inline int popLsb(Bitboard& b) {
+    int square = lsb(b);
+    b &= b - 1;
+    return square;
+}
+
+inline bool moreThanOne(Bitboard b) { return (b & (b - 1)) != 0; }
+
+// Leaper attack tables, built at compile time
+namespace detail {
+
+constexpr Bitboard leaperAttacks(int square, const int (*offsets)[2], int count) {
+    Bitboard attacks = 0;
+    for (int i = 0; i < count; i++) {
+        int row = (square >> 3) + offsets[i][0];
+        int col = (square & 7) + offsets[i][1];
+        if (row >= 0 && row < 8 && col >= 0 && col < 8) {
+            attacks |= 1ULL << (row * 8 + col);
+        }
+    }
+    return attacks;
+}
+
+constexpr int KNIGHT_OFFSETS[8][2] = {
+    {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}
+};
+constexpr int KING_OFFSETS[8][2] = {
+    {-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}
+};
+constexpr int WHITE_PAWN_OFFSETS[2][2] = {{1, -1}, {1, 1}};
+constexpr int BLACK_PAWN_OFFSETS[2][2] = {{-1, -1}, {-1, 1}};
+
+constexpr std::array<Bitboard, 64> makeTable(const int (*offsets)[2], int count) {
+    std::array<Bitboard, 64> table{};
+    for (int square = 0; square < 64; square++) {
+        table[square] = leaperAttacks(square, offsets, count);
+    }
+    return table;
+}
+
+constexpr std::array<Bitboard, 64> KNIGHT_ATTACKS = makeTable(KNIGHT_OFFSETS, 8);
+constexpr std::array<Bitboard, 64> KING_ATTACKS = makeTable(KING_OFFSETS, 8);
+constexpr std::array<std::array<Bitboard, 64>, 2> PAWN_ATTACKS = {
+    makeTable(WHITE_PAWN_OFFSETS, 2), makeTable(BLACK_PAWN_OFFSETS, 2)
+};
+
+} // namespace detail
+
+inline Bitboard knightAttacks(int square) { return detail::KNIGHT_ATTACKS[square]; }
+inline Bitboard kingAttacks(int square) { return detail::KING_ATTACKS[square]; }
+
+// Squares attacked by a pawn of the given color standing on square
+inline Bitboard pawnAttacks(Color color, int square) {
+    return detail::PAWN_ATTACKS[color == Color::WHITE ? 0 : 1][square];
+}
+
+// Build the sliding attack tables. Safe to call more than once and from several
+// threads; Board's constructor calls it, so code that has a Board never needs to.
+void init();
+
+// True if slider lookups use the BMI2 PEXT instruction instead of magic multiplication
+constexpr bool usingPext() {
+#ifdef BITBOARD_USE_PEXT
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Magic (or PEXT) lookup tables for sliding pieces
+namespace detail {
+
+struct SliderMagic {
+    Bitboard mask;       // Relevant occupancy (board edges excluded)
+    Bitboard magic;      // Multiplier for the magic index, unused with PEXT
+    Bitboard* attacks;   // Start of this square's slice of the attack table
+    unsigned shift;      // 64 - popcount(mask)
+};
+
+extern SliderMagic bishopMagics[64];
+extern SliderMagic rookMagics[64];
+
+inline unsigned sliderIndex(const SliderMagic& m, Bitboard occupied) {
+#ifdef BITBOARD_USE_PEXT
+    return static_cast<unsigned>(_pext_u64(occupied, m.mask));
+#else
+    return static_cast<unsigned>(((occupied & m.mask) * m.magic) >> m.shift);
+#endif
+}
+
+} // namespace detail
+
+// Sliding piece attacks for the given occupancy (blockers are included)
+inline Bitboard bishopAttacks(int square, Bitboard occupied) {
+    const detail::SliderMagic& m = detail::bishopMagics[square];
+    return m.attacks[detail::sliderIndex(m, occupied)];
+}
+inline Bitboard rookAttacks(int square, Bitboard occupied) {
+    const detail::SliderMagic& m = detail::rookMagics[square];
+    return m.attacks[detail::sliderIndex(m, occupied)];
+}
+inline Bitboard queenAttacks(int square, Bitboard occupied) {
+    return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+}
+
+// Squares strictly between two squares on a shared line, or empty if not aligned
+Bitboard between(int from, int to);
+
+// The full edge-to-edge line through two aligned squares, or empty if not aligned
+Bitboard line(int a, int b);
+
+} // namespace Bitboards
+
+#endif // BITBOARD_H
@@ -4,9 +4,63 @@
 #include <sstream>
 #include <algorithm>
 #include <climits>
+#include <type_traits>
 
-Board::Board() : squares(8, std::vector<std::shared_ptr<Piece>>(8, nullptr))
+static_assert(std::is_trivially_copyable<Board>::value, "Board copies must stay a plain memcpy");
+static_assert(sizeof(Board) < 200, "Board must stay under 200 bytes");
+static_assert(std::is_trivially_copyable<BoardState>::value, "BoardState must not own anything");
+
+namespace {
+
+// Shared piece objects handed out by getPieceAt, indexed by [color][type][square][hasMoved].
+// Built once; the board itself only stores bitboards and the mailbox.
+struct PieceViewTable {
+    std::shared_ptr<Piece> views[2][6][64][2];
+
+    static std::shared_ptr<Piece> create(PieceType type, Color color, const Position& pos) {
+        switch (type) {
+            case PieceType::PAWN: return std::make_shared<Pawn>(color, pos);
+            case PieceType::KNIGHT: return std::make_shared<Knight>(color, pos);
+            case PieceType::BISHOP: return std::make_shared<Bishop>(color, pos);
+            case PieceType::ROOK: return std::make_shared<Rook>(color, pos);
+            case PieceType::QUEEN: return std::make_shared<Queen>(color, pos);
+            case PieceType::KING: return std::make_shared<King>(color, pos);
+            default: return nullptr;
+        }
+    }
+
+    PieceViewTable() {
+        for (int c = 0; c < 2; c++) {
+            for (int t = 0; t < 6; t++) {
+                for (int square = 0; square < 64; square++) {
+                    for (int moved = 0; moved < 2; moved++) {
+                        auto piece = create(static_cast<PieceType>(t), c == 0 ? Color::WHITE : Color::BLACK,
+                                            Bitboards::fromSquare(square));
+                        piece->setHasMoved(moved != 0);
+                        views[c][t][square][moved] = piece;
+                    }
+                }
+            }
+        }
+    }
+};
+
+const PieceViewTable& pieceViews() {
+    static const PieceViewTable table;
+    return table;
+}
+
+char pieceToChar(PieceType type, Color color) {
+    static const char chars[] = "pnbrqk";
+    char c = chars[static_cast<int>(type)];
+    return color == Color::WHITE ? static_cast<char>(std::toupper(c)) : c;
+}
+
+} // namespace
+
+Board::Board()
 {
+    Bitboards::init();
     setupStartingPosition();
 }
 
@@ -15,40 +69,19 @@ void Board::setupStartingPosition()
     // Clear the board
     clear();
 
-    // Set up pawns
+    static const PieceType backRank[8] = {
+        PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN,
+        PieceType::KING, PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK
+    };
+
+    // Set up pawns and pieces
     for (int col = 0; col < 8; col++)
     {
-        setPieceAt(Position(1, col), std::make_shared<Pawn>(Color::WHITE, Position(1, col)));
-        setPieceAt(Position(6, col), std::make_shared<Pawn>(Color::BLACK, Position(6, col)));
-    }
-
-    // Set up rooks
-    setPieceAt(Position(0, 0), std::make_shared<Rook>(Color::WHITE, Position(0, 0)));
-    setPieceAt(Position(0, 7), std::make_shared<Rook>(Color::WHITE, Position(0, 7)));
-    setPieceAt(Position(7, 0), std::make_shared<Rook>(Color::BLACK, Position(7, 0)));
-    setPieceAt(Position(7, 7), std::make_shared<Rook>(Color::BLACK, Position(7, 7)));
-
-    // Set up knights
-    setPieceAt(Position(0, 1), std::make_shared<Knight>(Color::WHITE, Position(0, 1)));
-    setPieceAt(Position(0, 6), std::make_shared<Knight>(Color::WHITE, Position(0, 6)));
-    setPieceAt(Position(7, 1), std::make_shared<Knight>(Color::BLACK, Position(7, 1)));
-    setPieceAt(Position(7, 6), std::make_shared<Knight>(Color::BLACK, Position(7, 6)));
-
-    // Set up bishops
-    setPieceAt(Position(0, 2), std::make_shared<Bishop>(Color::WHITE, Position(0, 2)));
-    setPieceAt(Position(0, 5), std::make_shared<Bishop>(Color::WHITE, Position(0, 5)));
-    setPieceAt(Position(7, 2), std::make_shared<Bishop>(Color::BLACK, Position(7, 2)));
-    setPieceAt(Position(7, 5), std::make_shared<Bishop>(Color::BLACK, Position(7, 5)));
-
-    // Set up queens
-    setPieceAt(Position(0, 3), std::make_shared<Queen>(Color::WHITE, Position(0, 3)));
-    setPieceAt(Position(7, 3), std::make_shared<Queen>(Color::BLACK, Position(7, 3)));
-
-    // Set up kings
-    whiteKing = std::make_shared<King>(Color::WHITE, Position(0, 4));
-    blackKing = std::make_shared<King>(Color::BLACK, Position(7, 4));
-    setPieceAt(Position(0, 4), whiteKing);
-    setPieceAt(Position(7, 4), blackKing);
+        putPiece(8 + col, Color::WHITE, PieceType::PAWN);
+        putPiece(48 + col, Color::BLACK, PieceType::PAWN);
+        putPiece(col, Color::WHITE, backRank[col]);
+        putPiece(56 + col, Color::BLACK, backRank[col]);
+    }
 
     // Reset game state variables
     sideToMove = Color::WHITE;
@@ -56,9 +89,10 @@ void Board::setupStartingPosition()
     whiteCanCastleQueenside = true;
     blackCanCastleKingside = true;
     blackCanCastleQueenside = true;
-    enPassantTarget = Position();
+    enPassantSquare = -1;
     halfMoveClock = 0;
     fullMoveNumber = 1;
+    hashKey ^= stateKey();
 }
 
 void Board::setupFromFEN(const std::string& fen) {
@@ -150,45 +184,25 @@ void Board::setupFromFEN(const std::string& fen) {
         } else if (isdigit(c)) {
             col += c - '0';  // Skip empty squares
         } else {
-            // Create piece
-            Position pos(row, col);
-            std::shared_ptr<Piece> piece = nullptr;
+            // Place piece
             Color color = isupper(c) ? Color::WHITE : Color::BLACK;
             char pieceChar = tolower(c);
+            PieceType type = PieceType::NONE;
             
             switch (pieceChar) {
-                case 'p':
-                    piece = std::make_shared<Pawn>(color, pos);
-                    break;
-                case 'n':
-                    piece = std::make_shared<Knight>(color, pos);
-                    break;
-                case 'b':
-                    piece = std::make_shared<Bishop>(color, pos);
-                    break;
-                case 'r':
-                    piece = std::make_shared<Rook>(color, pos);
-                    break;
-                case 'q':
-                    piece = std::make_shared<Queen>(color, pos);
-                    break;
-                case 'k': {
-                    auto king = std::make_shared<King>(color, pos);
-                    piece = king;
-                    if (color == Color::WHITE) {
-                        whiteKing = king;
-                    } else {
-                        blackKing = king;
-                    }
-                    break;
-                }
+                case 'p': type = PieceType::PAWN; break;
+                case 'n': type = PieceType::KNIGHT; break;
+                case 'b': type = PieceType::BISHOP; break;
+                case 'r': type = PieceType::ROOK; break;
+                case 'q': type = PieceType::QUEEN; break;
+                case 'k': type = PieceType::KING; break;
                 default:
                     std::cerr << "Error: Unexpected piece character during parsing: " << c << std::endl;
                     setupStartingPosition();
                     return;
             }
             
-            setPieceAt(pos, piece);
+            putPiece(row * 8 + col, color, type);
             col++;
         }
     }
@@ -203,15 +217,20 @@ void Board::setupFromFEN(const std::string& fen) {
     blackCanCastleQueenside = castling.find('q') != std::string::npos;
     
     // Set en passant target
+    enPassantSquare = -1;
     if (enPassant != "-") {
-        enPassantTarget = Position::fromString(enPassant);
-    } else {
-        enPassantTarget = Position();
+        Position target = Position::fromString(enPassant);
+        if (target.isValid()) {
+            enPassantSquare = static_cast<int8_t>(Bitboards::toSquare(target));
+        }
     }
     
     // Set move counters
     halfMoveClock = halfMove;
     fullMoveNumber = fullMove;
+
+    // Pieces are already hashed by putPiece; add the rest of the state
+    hashKey ^= stateKey();
 }
 
 bool Board::validateFENBoardString(const std::string& boardStr) const {
@@ -299,15 +318,15 @@ std::string Board::toFEN() const
         int emptyCount = 0;
         for (int col = 0; col < 8; col++)
         {
-            auto piece = getPieceAt(Position(row, col));
-            if (piece)
+            int square = row * 8 + col;
+            if (!isEmpty(square))
             {
                 if (emptyCount > 0)
                 {
                     fen << emptyCount;
                     emptyCount = 0;
                 }
-                fen << piece->toChar();
+                fen << pieceToChar(getPieceTypeAt(square), getPieceColorAt(square));
             }
             else
             {
@@ -348,9 +367,9 @@ std::string Board::toFEN() const
 
     // En passant target square
     fen << ' ';
-    if (enPassantTarget.isValid())
+    if (enPassantSquare >= 0)
     {
-        fen << enPassantTarget.toString();
+        fen << getEnPassantTarget().toString();
     }
     else
     {
@@ -370,20 +389,120 @@ std::shared_ptr<Piece> Board::getPieceAt(const Position &pos) const
 {
     if (!pos.isValid())
         return nullptr;
-    return squares[pos.row][pos.col];
+
+    int square = Bitboards::toSquare(pos);
+    if (isEmpty(square))
+        return nullptr;
+
+    PieceType type = getPieceTypeAt(square);
+    Color color = getPieceColorAt(square);
+
+    // Derive "has moved" from the position: kings and rooks are unmoved while they
+    // still hold the matching castling right, pawns while on their starting rank
+    bool hasMoved = false;
+    bool white = (color == Color::WHITE);
+    switch (type) {
+        case PieceType::PAWN:
+            hasMoved = pos.row != (white ? 1 : 6);
+            break;
+        case PieceType::ROOK:
+            if (square == (white ? 0 : 56)) {
+                hasMoved = !(white ? whiteCanCastleQueenside : blackCanCastleQueenside);
+            } else if (square == (white ? 7 : 63)) {
+                hasMoved = !(white ? whiteCanCastleKingside : blackCanCastleKingside);
+            } else {
+                hasMoved = true;
+            }
+            break;
+        case PieceType::KING:
+            hasMoved = square != (white ? 4 : 60) ||
+                       !(white ? (whiteCanCastleKingside || whiteCanCastleQueenside)
+                               : (blackCanCastleKingside || blackCanCastleQueenside));
+            break;
+        default:
+            break;
+    }
+
+    return pieceViews().views[colorIndex(color)][static_cast<int>(type)][square][hasMoved ? 1 : 0];
 }
 
 void Board::setPieceAt(const Position &pos, std::shared_ptr<Piece> piece)
 {
     if (!pos.isValid())
         return;
-    squares[pos.row][pos.col] = piece;
+    int square = Bitboards::toSquare(pos);
+    removePiece(square);
     if (piece)
     {
-        piece->setPosition(pos);
+        putPiece(square, piece->getColor(), piece->getType());
     }
 }
 
+PieceType Board::getPieceTypeAt(int square) const {
+    uint8_t code = mailbox[square];
+    return code == NO_PIECE ? PieceType::NONE : static_cast<PieceType>(code % 6);
+}
+
+Color Board::getPieceColorAt(int square) const {
+    uint8_t code = mailbox[square];
+    if (code == NO_PIECE) return Color::NONE;
+    return code < 6 ? Color::WHITE : Color::BLACK;
+}
+
+int Board::getKingSquare(Color color) const {
+    Bitboard king = getPieces(color, PieceType::KING);
+    return king ? Bitboards::lsb(king) : -1;
+}
+
+void Board::putPiece(int square, Color color, PieceType type) {
+    int c = colorIndex(color);
+    int t = static_cast<int>(type);
+    Bitboard bb = Bitboards::squareBB(square);
+    typeBB[t] |= bb;
+    colorBB[c] |= bb;
+    mailbox[square] = static_cast<uint8_t>(c * 6 + t);
+    hashKey ^= Zobrist::pieceKey(color, type, square);
+    if (type == PieceType::PAWN) pawnKey ^= Zobrist::pieceKey(color, type, square);
+
+    material[c] += PSQT::material(type);
+    psq[PSQT::MIDDLEGAME][c] += PSQT::bonus(PSQT::MIDDLEGAME, color, type, square);
+    psq[PSQT::ENDGAME][c] += PSQT::bonus(PSQT::ENDGAME, color, type, square);
+    phase += PSQT::phaseWeight(type);
+}
+
+void Board::removePiece(int square) {
+    uint8_t code = mailbox[square];
+    if (code == NO_PIECE) return;
+    int c = code / 6;
+    int t = code % 6;
+    Bitboard bb = Bitboards::squareBB(square);
+    typeBB[t] &= ~bb;
+    colorBB[c] &= ~bb;
+    mailbox[square] = NO_PIECE;
+
+    Color color = c == 0 ? Color::WHITE : Color::BLACK;
+    PieceType type = static_cast<PieceType>(t);
+    hashKey ^= Zobrist::pieceKey(color, type, square);
+    if (type == PieceType::PAWN) pawnKey ^= Zobrist::pieceKey(color, type, square);
+
+    material[c] -= PSQT::material(type);
+    psq[PSQT::MIDDLEGAME][c] -= PSQT::bonus(PSQT::MIDDLEGAME, color, type, square);
+    psq[PSQT::ENDGAME][c] -= PSQT::bonus(PSQT::ENDGAME, color, type, square);
+    phase -= PSQT::phaseWeight(type);
+}
+
+int Board::castlingRights() const {
+    return (whiteCanCastleKingside ? 1 : 0) | (whiteCanCastleQueenside ? 2 : 0) |
+           (blackCanCastleKingside ? 4 : 0) | (blackCanCastleQueenside ? 8 : 0);
+}
+
+uint64_t Board::stateKey() const {
+    uint64_t key = Zobrist::castlingKey(castlingRights());
+    if (sideToMove == Color::BLACK) key ^= Zobrist::sideToMoveKey();
+    if (enPassantSquare >= 0) key ^= Zobrist::enPassantKey(Bitboards::colOf(enPassantSquare));
+    return key;
+}
+
 bool Board::makeMove(const Move& move) {
     BoardState dummy; // We don't need to save state for the public interface
     return makeMove(move, dummy);
@@ -392,55 +511,59 @@ bool Board::makeMove(const Move& move) {
 bool Board::makeMove(const Move &move, BoardState &previousState)
 {
     // STEP 1: Comprehensive input validation
-    if (!move.from.isValid() || !move.to.isValid()) {
-        std::cerr << "Error: Invalid move coordinates - from: " << move.from.toString() 
-                  << ", to: " << move.to.toString() << std::endl;
+    if (!move.from().isValid() || !move.to().isValid()) {
+        std::cerr << "Error: Invalid move coordinates - from: " << move.from().toString() 
+                  << ", to: " << move.to().toString() << std::endl;
         return false;
     }
     
+    int from = Bitboards::toSquare(move.from());
+    int to = Bitboards::toSquare(move.to());
+
     // STEP 2: Validate source piece exists
-    auto piece = getPieceAt(move.from);
-    if (!piece) {
-        std::cerr << "Error: No piece at source square " << move.from.toString() << std::endl;
+    if (isEmpty(from)) {
+        std::cerr << "Error: No piece at source square " << move.from().toString() << std::endl;
         return false;
     }
     
     // STEP 3: Validate piece ownership
-    if (piece->getColor() != sideToMove) {
-        std::cerr << "Error: Attempting to move opponent's piece at " << move.from.toString() 
-                  << " (piece color: " << (piece->getColor() == Color::WHITE ? "White" : "Black")
+    Color pieceColor = getPieceColorAt(from);
+    if (pieceColor != sideToMove) {
+        std::cerr << "Error: Attempting to move opponent's piece at " << move.from().toString() 
+                  << " (piece color: " << (pieceColor == Color::WHITE ? "White" : "Black")
                   << ", side to move: " << (sideToMove == Color::WHITE ? "White" : "Black") << ")" << std::endl;
         return false;
     }
     
     // STEP 4: Validate that target square is not occupied by own piece
-    auto targetPiece = getPieceAt(move.to);
-    if (targetPiece && targetPiece->getColor() == sideToMove) {
-        std::cerr << "Error: Cannot capture own piece at " << move.to.toString() << std::endl;
+    if (getPieceColorAt(to) == sideToMove) {
+        std::cerr << "Error: Cannot capture own piece at " << move.to().toString() << std::endl;
         return false;
     }
     
-    // STEP 5: Generate and validate legal moves (only if needed for complex validation)
+    // STEP 5: Generate and validate legal moves
+    Move flaggedMove;
     try {
         auto legalMoves = generateLegalMoves();
         bool moveIsLegal = false;
         
-        // Check if the move is in the list of legal moves
+        // Check if the move is in the list of legal moves. The generated move
+        // carries the capture/castling/en passant flags, so apply that one.
         for (const auto& legalMove : legalMoves) {
-            if (legalMove.from == move.from && legalMove.to == move.to && 
-                legalMove.promotion == move.promotion) {
+            if (legalMove.sameAs(move)) {
                 moveIsLegal = true;
+                flaggedMove = legalMove;
                 break;
             }
         }
         
         if (!moveIsLegal) {
             std::cerr << "Error: Illegal move attempted: " << move.toString() << std::endl;
-            std::cerr << "Legal moves from " << move.from.toString() << ": ";
+            std::cerr << "Legal moves from " << move.from().toString() << ": ";
             
             bool foundAnyFromSquare = false;
             for (const auto& legalMove : legalMoves) {
-                if (legalMove.from == move.from) {
+                if (legalMove.fromSquare() == move.fromSquare()) {
                     std::cerr << legalMove.toString() << " ";
                     foundAnyFromSquare = true;
                 }
@@ -456,156 +579,86 @@ bool Board::makeMove(const Move &move, BoardState &previousState)
         return false;
     }
     
-    // STEP 6: Save previous state before making any changes
+    // STEP 6: The move is legal - apply it
+    applyMove(flaggedMove, previousState);
+    return true;
+}
+
+void Board::applyMove(const Move& move, BoardState& previousState) {
+    int from = move.fromSquare();
+    int to = move.toSquare();
+    PieceType type = getPieceTypeAt(from);
+    Color color = getPieceColorAt(from);
+    PieceType capturedType = getPieceTypeAt(to);
+
+    // Save previous state before making any changes
     previousState.sideToMove = sideToMove;
     previousState.whiteCanCastleKingside = whiteCanCastleKingside;
     previousState.whiteCanCastleQueenside = whiteCanCastleQueenside;
     previousState.blackCanCastleKingside = blackCanCastleKingside;
     previousState.blackCanCastleQueenside = blackCanCastleQueenside;
-    previousState.enPassantTarget = enPassantTarget;
+    previousState.enPassantSquare = enPassantSquare;
     previousState.halfMoveClock = halfMoveClock;
     previousState.fullMoveNumber = fullMoveNumber;
-    previousState.capturedPiece = nullptr;
+    previousState.hashKey = hashKey;
+    previousState.capturedType = capturedType;
     previousState.wasEnPassant = false;
     previousState.wasPromotion = false;
-    previousState.pieceHasMoved = piece->getHasMoved();
 
-    // Handle castling BEFORE other validations
-    if (piece->getType() == PieceType::KING) {
-        // Kingside castling
-        if (move.from.col == 4 && move.to.col == 6) {
-            if (!canCastle(move)) {
-                return false;
-            }
-            
-            // Move the rook
-            auto rook = getPieceAt(Position(move.from.row, 7));
-            setPieceAt(Position(move.from.row, 5), rook);
-            setPieceAt(Position(move.from.row, 7), nullptr);
-            if (rook) rook->setMoved();
-        }
-        // Queenside castling
-        else if (move.from.col == 4 && move.to.col == 2) {
-            if (!canCastle(move)) {
-                return false;
-            }
-            
-            // Move the rook
-            auto rook = getPieceAt(Position(move.from.row, 0));
-            setPieceAt(Position(move.from.row, 3), rook);
-            setPieceAt(Position(move.from.row, 0), nullptr);
-            if (rook) rook->setMoved();
-        }
-    }
+    bool isPawnMove = (type == PieceType::PAWN);
+    bool isCapture = (capturedType != PieceType::NONE);
 
-    previousState.capturedPiece = getPieceAt(move.to);
+    // Take the old castling/en passant state out of the key; the new state is
+    // XORed back in once it is known. Piece keys are handled by put/removePiece.
+    hashKey ^= Zobrist::castlingKey(castlingRights());
+    if (enPassantSquare >= 0) hashKey ^= Zobrist::enPassantKey(Bitboards::colOf(enPassantSquare));
 
-    // Determine if this is a capture or pawn move 
-    bool isCapture = getPieceAt(move.to) != nullptr;
-    bool isPawnMove = piece->getType() == PieceType::PAWN;
+    // Castling: move the rook alongside the king
+    if (move.isCastle()) {
+        int rank = from & ~7;
+        bool kingside = move.flags() == Move::KING_CASTLE;
+        int rookFrom = rank + (kingside ? 7 : 0);
+        int rookTo = rank + (kingside ? 5 : 3);
+        removePiece(rookFrom);
+        putPiece(rookTo, color, PieceType::ROOK);
+    }
 
-    // Handle en passant capture with proper validation
-    if (isPawnMove && move.to == enPassantTarget && enPassantTarget.isValid()) {
-        // Validate that there's actually a pawn to capture
-        int capturedPawnRow = (sideToMove == Color::WHITE) ? move.to.row - 1 : move.to.row + 1;
-        Position capturedPawnPos(capturedPawnRow, move.to.col);
-        
-        auto capturedPawn = getPieceAt(capturedPawnPos);
-        
-        // COMPREHENSIVE en passant validation
-        if (capturedPawn && 
-            capturedPawn->getType() == PieceType::PAWN && 
-            capturedPawn->getColor() != sideToMove) {
-            
-            // Additional validation: The captured pawn should be on the correct rank
-            bool validRank = false;
-            if (sideToMove == Color::WHITE && capturedPawnRow == 4) {
-                validRank = true; // White capturing black pawn on 5th rank
-            } else if (sideToMove == Color::BLACK && capturedPawnRow == 3) {
-                validRank = true; // Black capturing white pawn on 4th rank
-            }
-            
-            if (validRank) {
-                // Valid en passant capture
-                previousState.capturedPiece = capturedPawn;
-                setPieceAt(capturedPawnPos, nullptr);
-                isCapture = true;
-                previousState.wasEnPassant = true;
-            } else {
-                // Invalid en passant - this shouldn't happen with correct move generation
-                return false;
-            }
-        } else {
-            // No valid pawn to capture - invalid en passant
-            return false;
-        }
+    // En passant: the captured pawn is behind the target square
+    if (move.isEnPassant()) {
+        int capturedSquare = (color == Color::WHITE) ? to - 8 : to + 8;
+        previousState.capturedType = PieceType::PAWN;
+        removePiece(capturedSquare);
+        previousState.wasEnPassant = true;
+        isCapture = true;
+    }
+
+    // Move the piece (promoting if it reaches the last rank)
+    removePiece(to);
+    removePiece(from);
+    PieceType placedType = type;
+    if (move.isPromotion()) {
+        placedType = move.promotion();
+        previousState.wasPromotion = true;
     }
+    putPiece(to, color, placedType);
 
     // Update en passant target square
-    if (isPawnMove && abs(move.to.row - move.from.row) == 2) {
-        // Set the en passant target square
-        int epRow = (sideToMove == Color::WHITE) ? move.from.row + 1 : move.from.row - 1;
-        enPassantTarget = Position(epRow, move.from.col);
+    if (move.flags() == Move::DOUBLE_PAWN_PUSH) {
+        enPassantSquare = static_cast<int8_t>((from + to) / 2);
     } else {
-        enPassantTarget = Position();
+        enPassantSquare = -1;
     }
-    
+
     // Update halfmove clock
     if (isCapture || isPawnMove) {
         halfMoveClock = 0;
     } else {
         halfMoveClock++;
     }
-    
-    // Save the original piece type for undoing promotions
-    previousState.originalType = piece->getType();
-    
-    // Get the original piece type before any modifications
-    auto originalPiece = getPieceAt(move.from);
-    PieceType originalPieceType = originalPiece->getType();
 
-    // Handle pawn promotion - FIXED memory safety
-    if (isPawnMove && (move.to.row == 0 || move.to.row == 7)) {
-        // Default to queen if no promotion specified (should not happen in normal play)
-        PieceType promotionType = (move.promotion != PieceType::NONE) ? move.promotion : PieceType::QUEEN;
-        
-        // Validate promotion type (only allow legal promotions)
-        if (promotionType != PieceType::QUEEN && promotionType != PieceType::ROOK && 
-            promotionType != PieceType::BISHOP && promotionType != PieceType::KNIGHT) {
-            promotionType = PieceType::QUEEN; // Default to queen for invalid types
-        }
-        
-        previousState.wasPromotion = true;
-        
-        // Create the promoted piece
-        std::shared_ptr<Piece> promotedPiece = nullptr;
-        Color pieceColor = piece->getColor();
-        
-        switch (promotionType) {
-            case PieceType::QUEEN:
-                promotedPiece = std::make_shared<Queen>(pieceColor, move.to);
-                break;
-            case PieceType::ROOK:
-                promotedPiece = std::make_shared<Rook>(pieceColor, move.to);
-                break;
-            case PieceType::BISHOP:
-                promotedPiece = std::make_shared<Bishop>(pieceColor, move.to);
-                break;
-            case PieceType::KNIGHT:
-                promotedPiece = std::make_shared<Knight>(pieceColor, move.to);
-                break;
-            default:
-                promotedPiece = std::make_shared<Queen>(pieceColor, move.to);
-                break;
-        }
-        
-        // Set the promoted piece as the piece to move
-        piece = promotedPiece;
-    }
-
-    // Update castling rights based on king or rook movement
-    if (piece->getType() == PieceType::KING) {
-        if (piece->getColor() == Color::WHITE) {
+    // Update castling rights: king moves, or anything leaving/arriving on a rook corner
+    if (type == PieceType::KING) {
+        if (color == Color::WHITE) {
             whiteCanCastleKingside = false;
             whiteCanCastleQueenside = false;
         } else {
@@ -613,44 +666,14 @@ bool Board::makeMove(const Move &move, BoardState &previousState)
             blackCanCastleQueenside = false;
         }
     }
-    
-    // Update castling rights if rook moves
-    if (piece->getType() == PieceType::ROOK) {
-        if (piece->getColor() == Color::WHITE) {
-            if (move.from == Position(0, 0)) {
-                whiteCanCastleQueenside = false;
-            } else if (move.from == Position(0, 7)) {
-                whiteCanCastleKingside = false;
-            }
-        } else {
-            if (move.from == Position(7, 0)) {
-                blackCanCastleQueenside = false;
-            } else if (move.from == Position(7, 7)) {
-                blackCanCastleKingside = false;
-            }
-        }
-    }
-    
-    // Update castling rights if rook is captured
-    if (targetPiece && targetPiece->getType() == PieceType::ROOK) {
-        if (move.to == Position(0, 0)) {
-            whiteCanCastleQueenside = false;
-        } else if (move.to == Position(0, 7)) {
-            whiteCanCastleKingside = false;
-        } else if (move.to == Position(7, 0)) {
-            blackCanCastleQueenside = false;
-        } else if (move.to == Position(7, 7)) {
-            blackCanCastleKingside = false;
-        }
-    }
+    if (from == 0 || to == 0) whiteCanCastleQueenside = false;
+    if (from == 7 || to == 7) whiteCanCastleKingside = false;
+    if (from == 56 || to == 56) blackCanCastleQueenside = false;
+    if (from == 63 || to == 63) blackCanCastleKingside = false;
 
-    // Now make the move (we know it's safe)
-    setPieceAt(move.from, nullptr);
-    setPieceAt(move.to, piece);
+    hashKey ^= Zobrist::castlingKey(castlingRights());
+    if (enPassantSquare >= 0) hashKey ^= Zobrist::enPassantKey(Bitboards::colOf(enPassantSquare));
 
-    // Mark the piece as moved
-    piece->setMoved();
-        
     // Update fullmove number
     if (sideToMove == Color::BLACK) {
         fullMoveNumber++;
@@ -658,60 +681,37 @@ bool Board::makeMove(const Move &move, BoardState &previousState)
 
     // Switch side to move
     switchSideToMove();
-
-    return true;
 }
 
 bool Board::unmakeMove(const Move& move, const BoardState& previousState) {
+    int from = move.fromSquare();
+    int to = move.toSquare();
+
     // Get the piece at the destination position
-    auto piece = getPieceAt(move.to);
-    if (!piece) return false;
-    
-    // If this was a promotion, create the original piece type (pawn)
-    if (previousState.wasPromotion) {
-        piece = std::make_shared<Pawn>(previousState.sideToMove, move.from);
-    }
+    if (isEmpty(to)) return false;
+    Color color = getPieceColorAt(to);
+    PieceType type = previousState.wasPromotion ? PieceType::PAWN : getPieceTypeAt(to);
     
     // Move the piece back to the source
-    setPieceAt(move.from, piece);
-    setPieceAt(move.to, nullptr);
-    
-    // If it didn't have moved status before, reset it
-    if (!previousState.pieceHasMoved) {
-        piece->setHasMoved(false);
-    }
+    removePiece(to);
+    putPiece(from, color, type);
     
     // Restore captured piece (if any)
-    if (previousState.wasEnPassant) {
-        // This was an en passant capture
-        int capturedPawnRow = (previousState.sideToMove == Color::WHITE) ? move.to.row - 1 : move.to.row + 1;
-        Position capturedPawnPos(capturedPawnRow, move.to.col);
-        setPieceAt(capturedPawnPos, previousState.capturedPiece);
-    } else if (previousState.capturedPiece) {
-        // Regular capture
-        setPieceAt(move.to, previousState.capturedPiece);
-    }
-    
-    // Handle castling move reversal
-    if (piece->getType() == PieceType::KING) {
-        // Kingside castling
-        if (move.from.col == 4 && move.to.col == 6) {
-            auto rook = getPieceAt(Position(move.from.row, 5));
-            setPieceAt(Position(move.from.row, 7), rook);
-            setPieceAt(Position(move.from.row, 5), nullptr);
-            if (rook && !previousState.pieceHasMoved) {
-                rook->setHasMoved(false);
-            }
-        }
-        // Queenside castling
-        else if (move.from.col == 4 && move.to.col == 2) {
-            auto rook = getPieceAt(Position(move.from.row, 3));
-            setPieceAt(Position(move.from.row, 0), rook);
-            setPieceAt(Position(move.from.row, 3), nullptr);
-            if (rook && !previousState.pieceHasMoved) {
-                rook->setHasMoved(false);
-            }
+    if (previousState.capturedType != PieceType::NONE) {
+        int capturedSquare = to;
+        if (previousState.wasEnPassant) {
+            capturedSquare = (color == Color::WHITE) ? to - 8 : to + 8;
         }
+        Color capturedColor = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+        putPiece(capturedSquare, capturedColor, previousState.capturedType);
+    }
+    
+    // Handle castling move reversal (by geometry, so unflagged caller moves work too)
+    if (type == PieceType::KING && std::abs(Bitboards::colOf(to) - Bitboards::colOf(from)) == 2) {
+        int rank = from & ~7;
+        bool kingside = Bitboards::colOf(to) == 6;
+        removePiece(rank + (kingside ? 5 : 3));
+        putPiece(rank + (kingside ? 7 : 0), color, PieceType::ROOK);
     }
     
     // Restore all game state
@@ -720,102 +720,442 @@ bool Board::unmakeMove(const Move& move, const BoardState& previousState) {
     whiteCanCastleQueenside = previousState.whiteCanCastleQueenside;
     blackCanCastleKingside = previousState.blackCanCastleKingside;
     blackCanCastleQueenside = previousState.blackCanCastleQueenside;
-    enPassantTarget = previousState.enPassantTarget;
+    enPassantSquare = previousState.enPassantSquare;
     halfMoveClock = previousState.halfMoveClock;
     fullMoveNumber = previousState.fullMoveNumber;
+    hashKey = previousState.hashKey;
     
     return true;
 }
 
-std::vector<Move> Board::generateLegalMoves() const {
-    std::vector<Move> legalMoves;
-    
-    // Generate moves for all pieces of the current side
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            Position pos(row, col);
-            auto piece = getPieceAt(pos);
-            
-            if (piece && piece->getColor() == sideToMove) {
-                auto pieceMoves = piece->getLegalMoves(*this);
-                
-                // Filter out moves that would leave king in check
-                for (const auto& move : pieceMoves) {
-                    if (!wouldBeInCheck(move, sideToMove)) {
-                        legalMoves.push_back(move);
+Bitboard Board::getPinnedPieces(Color color) const {
+    int kingSquare = getKingSquare(color);
+    if (kingSquare < 0) return 0;
+
+    const Color enemy = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    const Bitboard queens = getPieces(enemy, PieceType::QUEEN);
+    const Bitboard occupied = getOccupied();
+
+    // Enemy sliders that would see the king on an empty board
+    Bitboard snipers =
+        (Bitboards::rookAttacks(kingSquare, 0) & (getPieces(enemy, PieceType::ROOK) | queens)) |
+        (Bitboards::bishopAttacks(kingSquare, 0) & (getPieces(enemy, PieceType::BISHOP) | queens));
+
+    // A sniper pins our piece if it is the only blocker in between
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = Bitboards::between(kingSquare, Bitboards::popLsb(snipers)) & occupied;
+        if (blockers && !Bitboards::moreThanOne(blockers)) {
+            pinned |= blockers & getPieces(color);
+        }
+    }
+    return pinned;
+}
+
+void Board::generateMoves(MoveList& moves, bool legalOnly, MoveGenType type) const {
+    const Color us = sideToMove;
+    const Color them = (us == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    const Bitboard own = getPieces(us);
+    const Bitboard enemy = getPieces(them);
+    const Bitboard occupied = own | enemy;
+    const int forward = (us == Color::WHITE) ? 8 : -8;
+    const int startRow = (us == Color::WHITE) ? 1 : 6;
+    const int promotionRow = (us == Color::WHITE) ? 7 : 0;
+    const int kingSquare = getKingSquare(us);
+    legalOnly = legalOnly && kingSquare >= 0;
+    const bool wantCaptures = type != MoveGenType::QUIETS;
+    const bool wantQuiets = type != MoveGenType::CAPTURES;
+
+    // Legality masks, computed once per position:
+    // - checkers: enemy pieces giving check
+    // - evasionMask: squares a non-king move must land on (block or capture when in single check)
+    // - pinned: our pieces that may only move along the line through our king
+    Bitboard checkers = 0;
+    Bitboard pinned = 0;
+    Bitboard evasionMask = ~0ULL;
+    if (legalOnly) {
+        checkers = attackersTo(kingSquare, occupied) & enemy;
+        pinned = getPinnedPieces(us);
+        if (checkers) {
+            evasionMask = Bitboards::moreThanOne(checkers)
+                              ? 0 // Double check: only the king can move
+                              : Bitboards::between(kingSquare, Bitboards::lsb(checkers)) | checkers;
+        }
+    }
+
+    // Destinations allowed for a non-king piece on square from
+    auto allowed = [&](int from) {
+        Bitboard mask = evasionMask;
+        if (pinned & Bitboards::squareBB(from)) {
+            mask &= Bitboards::line(kingSquare, from);
+        }
+        return mask;
+    };
+
+    auto addPawnMove = [&](int from, int to) {
+        int capture = (enemy & Bitboards::squareBB(to)) ? Move::CAPTURE : 0;
+        bool promotion = Bitboards::rowOf(to) == promotionRow;
+        if (!(capture || promotion ? wantCaptures : wantQuiets)) return;
+        if (promotion) {
+            moves.emplace_back(from, to, Move::promotionFlag(PieceType::QUEEN) | capture);
+            moves.emplace_back(from, to, Move::promotionFlag(PieceType::ROOK) | capture);
+            moves.emplace_back(from, to, Move::promotionFlag(PieceType::BISHOP) | capture);
+            moves.emplace_back(from, to, Move::promotionFlag(PieceType::KNIGHT) | capture);
+        } else {
+            moves.emplace_back(from, to, capture);
+        }
+    };
+
+    auto addTargets = [&](int from, Bitboard targets) {
+        Bitboard captures = wantCaptures ? targets & enemy : 0;
+        Bitboard quiets = wantQuiets ? targets & ~enemy : 0;
+        while (captures) {
+            moves.emplace_back(from, Bitboards::popLsb(captures), Move::CAPTURE);
+        }
+        while (quiets) {
+            moves.emplace_back(from, Bitboards::popLsb(quiets), Move::QUIET);
+        }
+    };
+
+    int epSquare = enPassantSquare;
+
+    Bitboard pieces = own;
+    while (pieces) {
+        int from = Bitboards::popLsb(pieces);
+        PieceType type = getPieceTypeAt(from);
+
+        if (type == PieceType::KING) {
+            Bitboard targets = Bitboards::kingAttacks(from) & ~own;
+            if (legalOnly) {
+                // The king may not step onto an attacked square; remove it from the
+                // occupancy so sliders see through its current square
+                Bitboard withoutKing = occupied ^ Bitboards::squareBB(from);
+                Bitboard safe = 0;
+                Bitboard candidates = targets;
+                while (candidates) {
+                    int to = Bitboards::popLsb(candidates);
+                    if (!(attackersTo(to, withoutKing) & enemy)) {
+                        safe |= Bitboards::squareBB(to);
                     }
                 }
+                targets = safe;
+            }
+            addTargets(from, targets);
+
+            if (wantQuiets && !checkers && Bitboards::colOf(from) == 4) {
+                Move kingside(from, from + 2, Move::KING_CASTLE);
+                Move queenside(from, from - 2, Move::QUEEN_CASTLE);
+                if (canCastle(kingside)) moves.push_back(kingside);
+                if (canCastle(queenside)) moves.push_back(queenside);
             }
+            continue;
+        }
+
+        const Bitboard mask = allowed(from);
+        if (!mask) continue;
+
+        switch (type) {
+            case PieceType::PAWN: {
+                int oneStep = from + forward;
+                if (oneStep >= 0 && oneStep < 64 && isEmpty(oneStep)) {
+                    if (mask & Bitboards::squareBB(oneStep)) {
+                        addPawnMove(from, oneStep);
+                    }
+                    int twoStep = oneStep + forward;
+                    if (wantQuiets && Bitboards::rowOf(from) == startRow && isEmpty(twoStep) &&
+                        (mask & Bitboards::squareBB(twoStep))) {
+                        moves.emplace_back(from, twoStep, Move::DOUBLE_PAWN_PUSH);
+                    }
+                }
+                Bitboard attacks = Bitboards::pawnAttacks(us, from);
+                Bitboard captures = attacks & enemy & mask;
+                while (captures) {
+                    addPawnMove(from, Bitboards::popLsb(captures));
+                }
+                // En passant: target must be attacked and the captured pawn must be behind it
+                if (wantCaptures && epSquare >= 0 && (attacks & Bitboards::squareBB(epSquare))) {
+                    int capturedSquare = epSquare - forward;
+                    if (getPieceTypeAt(capturedSquare) == PieceType::PAWN &&
+                        getPieceColorAt(capturedSquare) == them &&
+                        (!legalOnly || isEnPassantLegal(from, epSquare, capturedSquare))) {
+                        moves.emplace_back(from, epSquare, Move::EN_PASSANT);
+                    }
+                }
+                break;
+            }
+            case PieceType::KNIGHT:
+                addTargets(from, Bitboards::knightAttacks(from) & ~own & mask);
+                break;
+            case PieceType::BISHOP:
+                addTargets(from, Bitboards::bishopAttacks(from, occupied) & ~own & mask);
+                break;
+            case PieceType::ROOK:
+                addTargets(from, Bitboards::rookAttacks(from, occupied) & ~own & mask);
+                break;
+            case PieceType::QUEEN:
+                addTargets(from, Bitboards::queenAttacks(from, occupied) & ~own & mask);
+                break;
+            default:
+                break;
         }
     }
-    
+}
+
+bool Board::isEnPassantLegal(int from, int to, int capturedSquare) const {
+    // En passant removes two pieces from one line, so pins and checks are
+    // verified directly against the resulting occupancy
+    Color us = getPieceColorAt(from);
+    Color them = (us == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    int kingSquare = getKingSquare(us);
+    if (kingSquare < 0) return true;
+
+    Bitboard occupied = (getOccupied() ^ Bitboards::squareBB(from) ^ Bitboards::squareBB(capturedSquare)) |
+                        Bitboards::squareBB(to);
+    Bitboard attackers = attackersTo(kingSquare, occupied) & getPieces(them) & ~Bitboards::squareBB(capturedSquare);
+    return attackers == 0;
+}
+
+void Board::generatePseudoLegalMoves(MoveList& moves) const {
+    generateMoves(moves, false);
+}
+
+void Board::generateCaptures(MoveList& moves) const {
+    generateMoves(moves, false, MoveGenType::CAPTURES);
+}
+
+void Board::generateQuiets(MoveList& moves) const {
+    generateMoves(moves, false, MoveGenType::QUIETS);
+}
+
+void Board::generateEvasions(MoveList& moves) const {
+    generateMoves(moves, true);
+}
+
+bool Board::isPseudoLegal(const Move& move) const {
+    if (move.isNull()) return false;
+
+    // Captures combine with nothing but promotion (en passant has its own code)
+    int flags = move.flags();
+    if ((flags & Move::CAPTURE) && !(flags & Move::PROMOTION) && flags != Move::CAPTURE && flags != Move::EN_PASSANT) {
+        return false;
+    }
+
+    int from = move.fromSquare();
+    int to = move.toSquare();
+    PieceType type = getPieceTypeAt(from);
+    if (type == PieceType::NONE || getPieceColorAt(from) != sideToMove) return false;
+
+    const Color us = sideToMove;
+    const Color them = (us == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    const Bitboard target = Bitboards::squareBB(to);
+    if (getPieces(us) & target) return false;
+
+    if (move.isCastle()) {
+        // canCastle checks rights, the rook, the path and attacked squares
+        return type == PieceType::KING && to == from + (move.flags() == Move::KING_CASTLE ? 2 : -2) &&
+               canCastle(move);
+    }
+
+    const int forward = (us == Color::WHITE) ? 8 : -8;
+    if (move.isEnPassant()) {
+        int capturedSquare = to - forward;
+        return type == PieceType::PAWN && enPassantSquare == to &&
+               (Bitboards::pawnAttacks(us, from) & target) && getPieceTypeAt(capturedSquare) == PieceType::PAWN &&
+               getPieceColorAt(capturedSquare) == them;
+    }
+
+    // The capture flag has to agree with what stands on the destination
+    bool capture = (getPieces(them) & target) != 0;
+    if (move.isCapture() != capture) return false;
+
+    const Bitboard occupied = getOccupied();
+    switch (type) {
+        case PieceType::PAWN: {
+            bool promotionRank = Bitboards::rowOf(to) == ((us == Color::WHITE) ? 7 : 0);
+            if (move.isPromotion() != promotionRank) return false;
+            if (capture) return (Bitboards::pawnAttacks(us, from) & target) != 0;
+            if (move.flags() == Move::DOUBLE_PAWN_PUSH) {
+                int startRow = (us == Color::WHITE) ? 1 : 6;
+                return Bitboards::rowOf(from) == startRow && to == from + 2 * forward &&
+                       isEmpty(from + forward) && isEmpty(to);
+            }
+            return to == from + forward && isEmpty(to);
+        }
+        case PieceType::KNIGHT:
+        case PieceType::BISHOP:
+        case PieceType::ROOK:
+        case PieceType::QUEEN:
+        case PieceType::KING: {
+            if (move.isPromotion() || move.flags() == Move::DOUBLE_PAWN_PUSH) return false;
+            Bitboard attacks = 0;
+            if (type == PieceType::KNIGHT) attacks = Bitboards::knightAttacks(from);
+            else if (type == PieceType::BISHOP) attacks = Bitboards::bishopAttacks(from, occupied);
+            else if (type == PieceType::ROOK) attacks = Bitboards::rookAttacks(from, occupied);
+            else if (type == PieceType::QUEEN) attacks = Bitboards::queenAttacks(from, occupied);
+            else attacks = Bitboards::kingAttacks(from);
+            return (attacks & target) != 0;
+        }
+        default:
+            return false;
+    }
+}
+
+MoveList Board::generateLegalMoves() const {
+    MoveList legalMoves;
+    generateMoves(legalMoves, true);
     return legalMoves;
 }
 
+bool Board::makePseudoLegalMove(const Move& move, BoardState& previousState) {
+    Color mover = sideToMove;
+    applyMove(move, previousState);
+
+    // Lazy legality check: reject (and take back) moves that leave our king in check
+    int kingSquare = getKingSquare(mover);
+    Color enemyColor = (mover == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    if (kingSquare >= 0 && (attackersTo(kingSquare, getOccupied()) & getPieces(enemyColor))) {
+        unmakeMove(move, previousState);
+        return false;
+    }
+    return true;
+}
+
+void Board::keysAfter(const Move& move, uint64_t& key, uint64_t& childPawnKey) const {
+    int from = move.fromSquare();
+    int to = move.toSquare();
+    PieceType type = getPieceTypeAt(from);
+    Color color = getPieceColorAt(from);
+    Color enemy = (color == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    PieceType capturedType = getPieceTypeAt(to);
+
+    key = hashKey ^ Zobrist::sideToMoveKey() ^ Zobrist::castlingKey(castlingRights());
+    if (enPassantSquare >= 0) key ^= Zobrist::enPassantKey(Bitboards::colOf(enPassantSquare));
+    childPawnKey = pawnKey;
+
+    // Mirrors applyMove
+    if (move.isCastle()) {
+        int rank = from & ~7;
+        bool kingside = move.flags() == Move::KING_CASTLE;
+        key ^= Zobrist::pieceKey(color, PieceType::ROOK, rank + (kingside ? 7 : 0));
+        key ^= Zobrist::pieceKey(color, PieceType::ROOK, rank + (kingside ? 5 : 3));
+    }
+    if (move.isEnPassant()) {
+        int capturedSquare = (color == Color::WHITE) ? to - 8 : to + 8;
+        uint64_t pawn = Zobrist::pieceKey(enemy, PieceType::PAWN, capturedSquare);
+        key ^= pawn;
+        childPawnKey ^= pawn;
+    }
+    if (capturedType != PieceType::NONE) {
+        uint64_t captured = Zobrist::pieceKey(enemy, capturedType, to);
+        key ^= captured;
+        if (capturedType == PieceType::PAWN) childPawnKey ^= captured;
+    }
+
+    PieceType placedType = move.isPromotion() ? move.promotion() : type;
+    key ^= Zobrist::pieceKey(color, type, from) ^ Zobrist::pieceKey(color, placedType, to);
+    if (type == PieceType::PAWN) childPawnKey ^= Zobrist::pieceKey(color, type, from);
+    if (placedType == PieceType::PAWN) childPawnKey ^= Zobrist::pieceKey(color, placedType, to);
+
+    int rights = castlingRights();
+    if (type == PieceType::KING) rights &= (color == Color::WHITE) ? ~3 : ~12;
+    if (from == 0 || to == 0) rights &= ~2;
+    if (from == 7 || to == 7) rights &= ~1;
+    if (from == 56 || to == 56) rights &= ~8;
+    if (from == 63 || to == 63) rights &= ~4;
+    key ^= Zobrist::castlingKey(rights);
+    if (move.flags() == Move::DOUBLE_PAWN_PUSH) key ^= Zobrist::enPassantKey(to & 7);
+}
+
 bool Board::isInCheck() const {
     // Find our king
-    auto king = (sideToMove == Color::WHITE) ? whiteKing : blackKing;
-    if (!king) return false;
+    int kingSquare = getKingSquare(sideToMove);
+    if (kingSquare < 0) return false;
     
-    Position kingPos = king->getPosition();
     Color enemyColor = (sideToMove == Color::WHITE) ? Color::BLACK : Color::WHITE;
-    
-    return isSquareAttacked(kingPos, enemyColor);
+    return isSquareAttacked(Bitboards::fromSquare(kingSquare), enemyColor);
+}
+
+bool Board::hasLegalMove() const {
+    const Color us = sideToMove;
+    const Color them = (us == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    const int kingSquare = getKingSquare(us);
+    if (kingSquare >= 0) {
+        // A king step is legal if the square is not attacked once the king has left
+        Bitboard enemy = getPieces(them);
+        Bitboard occupied = getOccupied() ^ Bitboards::squareBB(kingSquare);
+        Bitboard targets = Bitboards::kingAttacks(kingSquare) & ~getPieces(us);
+        while (targets) {
+            if (!(attackersTo(Bitboards::popLsb(targets), occupied) & enemy)) {
+                return true;
+            }
+        }
+    }
+
+    MoveList moves;
+    generateMoves(moves, true);
+    return !moves.empty();
 }
 
 bool Board::isCheckmate() const {
     if (!isInCheck()) return false;
     
     // If in check, see if there are any legal moves
-    auto legalMoves = generateLegalMoves();
-    return legalMoves.empty();
+    return !hasLegalMove();
 }
 
 bool Board::isStalemate() const {
     if (isInCheck()) return false;
     
     // If not in check, see if there are any legal moves
-    auto legalMoves = generateLegalMoves();
-    return legalMoves.empty();
+    return !hasLegalMove();
 }
 
 bool Board::isGameOver() const {
     return isCheckmate() || isStalemate();
 }
 
+Bitboard Board::attackersTo(int square, Bitboard occupied) const {
+    const int P = static_cast<int>(PieceType::PAWN);
+    const int N = static_cast<int>(PieceType::KNIGHT);
+    const int B = static_cast<int>(PieceType::BISHOP);
+    const int R = static_cast<int>(PieceType::ROOK);
+    const int Q = static_cast<int>(PieceType::QUEEN);
+    const int K = static_cast<int>(PieceType::KING);
+
+    Bitboard diagonalSliders = typeBB[B] | typeBB[Q];
+    Bitboard straightSliders = typeBB[R] | typeBB[Q];
+
+    // A white pawn attacks this square if a black pawn standing here would attack it, and vice versa
+    return (Bitboards::pawnAttacks(Color::BLACK, square) & typeBB[P] & colorBB[0]) |
+           (Bitboards::pawnAttacks(Color::WHITE, square) & typeBB[P] & colorBB[1]) |
+           (Bitboards::knightAttacks(square) & typeBB[N]) |
+           (Bitboards::kingAttacks(square) & typeBB[K]) |
+           (Bitboards::bishopAttacks(square, occupied) & diagonalSliders) |
+           (Bitboards::rookAttacks(square, occupied) & straightSliders);
+}
+
 bool Board::isSquareAttacked(const Position& pos, Color attackerColor) const {
-    // Check all squares for pieces of the attacking color
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            Position piecePos(row, col);
-            auto piece = getPieceAt(piecePos);
-            
-            if (piece && piece->getColor() == attackerColor) {
-                // Check if this piece can attack the target square
-                // Use direct piece-specific attack patterns instead of getLegalMoves()
-                if (canPieceAttackSquare(piece, piecePos, pos)) {
-                    return true;
-                }
-            }
-        }
-    }
-    return false;
+    if (!pos.isValid() || attackerColor == Color::NONE) return false;
+    return (attackersTo(Bitboards::toSquare(pos), getOccupied()) & getPieces(attackerColor)) != 0;
 }
 
 bool Board::canCastle(const Move& move) const {
-    auto piece = getPieceAt(move.from);
-    if (!piece || piece->getType() != PieceType::KING) {
+    int from = move.fromSquare();
+    if (getPieceTypeAt(from) != PieceType::KING) {
         return false;
     }
     
-    Color kingColor = piece->getColor();
-    bool isKingside = (move.to.col == 6);
-    bool isQueenside = (move.to.col == 2);
+    Color kingColor = getPieceColorAt(from);
+    bool isKingside = (Bitboards::colOf(move.toSquare()) == 6);
+    bool isQueenside = (Bitboards::colOf(move.toSquare()) == 2);
     
     if (!isKingside && !isQueenside) {
         return false;
     }
     
+    // King must be on its original square
+    if (from != (kingColor == Color::WHITE ? 4 : 60)) return false;
+    
     // Check castling rights
     if (kingColor == Color::WHITE) {
         if (isKingside && !whiteCanCastleKingside) return false;
@@ -825,35 +1165,23 @@ bool Board::canCastle(const Move& move) const {
         if (isQueenside && !blackCanCastleQueenside) return false;
     }
     
-    // Check if king has moved
-    if (piece->getHasMoved()) return false;
-    
-    // Check if rook exists and hasn't moved
-    int rookCol = isKingside ? 7 : 0;
-    auto rook = getPieceAt(Position(move.from.row, rookCol));
-    if (!rook || rook->getType() != PieceType::ROOK || rook->getHasMoved()) {
+    // Check if rook exists
+    int rookSquare = from - 4 + (isKingside ? 7 : 0);
+    if (getPieceTypeAt(rookSquare) != PieceType::ROOK || getPieceColorAt(rookSquare) != kingColor) {
         return false;
     }
     
     // Check if path is clear
-    int startCol = std::min(move.from.col, rookCol);
-    int endCol = std::max(move.from.col, rookCol);
-    
-    for (int col = startCol + 1; col < endCol; col++) {
-        if (getPieceAt(Position(move.from.row, col))) {
-            return false;
-        }
+    if (!isPathClear(move.from(), Bitboards::fromSquare(rookSquare))) {
+        return false;
     }
     
-    // Check if king is in check
-    if (isInCheck()) return false;
-    
-    // Check if king would pass through or land on an attacked square
+    // Check if king is in check or would pass through or land on an attacked square
     Color enemyColor = (kingColor == Color::WHITE) ? Color::BLACK : Color::WHITE;
     int direction = isKingside ? 1 : -1;
     
-    for (int i = 1; i <= 2; i++) {
-        Position testPos(move.from.row, move.from.col + (i * direction));
+    for (int i = 0; i <= 2; i++) {
+        Position testPos(move.from().row, move.from().col + (i * direction));
         if (isSquareAttacked(testPos, enemyColor)) {
             return false;
         }
@@ -864,11 +1192,11 @@ bool Board::canCastle(const Move& move) const {
 
 bool Board::isValidMovePattern(std::shared_ptr<Piece> piece, const Move& move) const {
     // This is a simplified version - full implementation would check piece-specific movement patterns
-    auto legalMoves = piece->getLegalMoves(*this);
+    MoveList legalMoves;
+    piece->getLegalMoves(*this, legalMoves);
     
     for (const auto& legalMove : legalMoves) {
-        if (legalMove.from == move.from && legalMove.to == move.to && 
-            legalMove.promotion == move.promotion) {
+        if (legalMove.sameAs(move)) {
             return true;
         }
     }
@@ -876,26 +1204,6 @@ bool Board::isValidMovePattern(std::shared_ptr<Piece> piece, const Move& move) c
     return false;
 }
 
-bool Board::wouldBeInCheck(const Move& move, Color kingColor) const {
-    // Make a copy of the board state to test the move
-    Board testBoard = *this;
-    BoardState tempState;
-    
-    // Try to make the move on the test board
-    if (!testBoard.makeMove(move, tempState)) {
-        return true; // Invalid move, consider it as leaving king in check
-    }
-    
-    // Check if the king is in check after the move
-    testBoard.sideToMove = kingColor; // Set to check the correct king
-    bool inCheck = testBoard.isInCheck();
-    
-    // Restore the move
-    testBoard.unmakeMove(move, tempState);
-    
-    return inCheck;
-}
-
 void Board::print() const {
     std::cout << "\n  a b c d e f g h\n";
     for (int row = 7; row >= 0; row--) {
@@ -925,8 +1233,8 @@ void Board::print() const {
     }
     std::cout << std::endl;
     
-    if (enPassantTarget.isValid()) {
-        std::cout << "En passant target: " << enPassantTarget.toString() << std::endl;
+    if (enPassantSquare >= 0) {
+        std::cout << "En passant target: " << getEnPassantTarget().toString() << std::endl;
     }
     
     std::cout << "Halfmove clock: " << halfMoveClock << std::endl;
@@ -934,83 +1242,23 @@ void Board::print() const {
 }
 
 void Board::clear() {
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            squares[row][col] = nullptr;
-        }
+    hashKey = 0;
+    pawnKey = 0;
+    phase = 0;
+    for (int c = 0; c < 2; c++) {
+        colorBB[c] = 0;
+        material[c] = 0;
+        psq[PSQT::MIDDLEGAME][c] = 0;
+        psq[PSQT::ENDGAME][c] = 0;
     }
-    whiteKing = nullptr;
-    blackKing = nullptr;
-}
-
-bool Board::canPieceAttackSquare(std::shared_ptr<Piece> piece, const Position& from, const Position& target) const {
-    if (!piece) return false;
-    
-    PieceType type = piece->getType();
-    Color color = piece->getColor();
-    
-    int rowDiff = target.row - from.row;
-    int colDiff = target.col - from.col;
-    int absRowDiff = abs(rowDiff);
-    int absColDiff = abs(colDiff);
-    
-    switch (type) {
-        case PieceType::PAWN: {
-            int direction = (color == Color::WHITE) ? 1 : -1;
-            // Pawns attack diagonally
-            return (rowDiff == direction && absColDiff == 1);
-        }
-        
-        case PieceType::KNIGHT: {
-            // Knight moves in L-shape
-            return (absRowDiff == 2 && absColDiff == 1) || (absRowDiff == 1 && absColDiff == 2);
-        }
-        
-        case PieceType::BISHOP: {
-            // Bishop moves diagonally
-            if (absRowDiff != absColDiff) return false;
-            return isPathClear(from, target);
-        }
-        
-        case PieceType::ROOK: {
-            // Rook moves horizontally or vertically
-            if (rowDiff != 0 && colDiff != 0) return false;
-            return isPathClear(from, target);
-        }
-        
-        case PieceType::QUEEN: {
-            // Queen combines rook and bishop
-            bool straightLine = (rowDiff == 0 || colDiff == 0);
-            bool diagonal = (absRowDiff == absColDiff);
-            if (!straightLine && !diagonal) return false;
-            return isPathClear(from, target);
-        }
-        
-        case PieceType::KING: {
-            // King moves one square in any direction
-            return (absRowDiff <= 1 && absColDiff <= 1 && (absRowDiff != 0 || absColDiff != 0));
-        }
-        
-        default:
-            return false;
+    for (int t = 0; t < 6; t++) {
+        typeBB[t] = 0;
+    }
+    for (int square = 0; square < 64; square++) {
+        mailbox[square] = NO_PIECE;
     }
 }
 
 bool Board::isPathClear(const Position& from, const Position& to) const {
-    int rowDir = (to.row > from.row) ? 1 : (to.row < from.row) ? -1 : 0;
-    int colDir = (to.col > from.col) ? 1 : (to.col < from.col) ? -1 : 0;
-    
-    Position current = from;
-    current.row += rowDir;
-    current.col += colDir;
-    
-    while (current.row != to.row || current.col != to.col) {
-        if (getPieceAt(current) != nullptr) {
-            return false; // Path is blocked
-        }
-        current.row += rowDir;
-        current.col += colDir;
-    }
-    
-    return true;
+    return (Bitboards::between(Bitboards::toSquare(from), Bitboards::toSquare(to)) & getOccupied()) == 0;
 }
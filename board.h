@@ -5,23 +5,53 @@
 #include "piece.h"
 #include "piece_types.h"
 #include "board_state.h"
+#include "bitboard.h"
+#include "movelist.h"
+#include "zobrist.h"
+#include "psqt.h"
 #include <vector>      // For std::vector
 #include <memory>      // For std::shared_ptr
 
+// Which pseudo-legal moves a generator call produces. Captures include en
+// passant and every promotion; quiets are all the other moves.
+enum class MoveGenType { ALL, CAPTURES, QUIETS };
+
+// Board is a plain value type: trivially copyable and under 200 bytes, so a
+// copy is a memcpy and never touches the heap. Members are ordered by size to
+// keep the padding out.
 class Board {
 private:
-    std::vector<std::vector<std::shared_ptr<Piece>>> squares;
+    // Piece placement: one bitboard per piece type (both colors), per-color
+    // occupancy, and a square-indexed mailbox for O(1) "what is on this square"
+    // lookups
+    Bitboard typeBB[6];
+    Bitboard colorBB[2];
+
+    // Zobrist key of the position, kept up to date by every mutator
+    uint64_t hashKey;
+
+    // Zobrist key over the pawns alone, for the engine's pawn hash table
+    uint64_t pawnKey;
+
+    uint8_t mailbox[64];
+
+    int halfMoveClock; // for 50-move rule
+    int fullMoveNumber;
+
+    // Running evaluation terms, updated by putPiece/removePiece:
+    // non-king material and piece-square sums per [stage][color], plus game phase
+    int material[2];
+    int psq[2][2];
+    int phase;
+
     Color sideToMove;
     bool whiteCanCastleKingside;
     bool whiteCanCastleQueenside;
     bool blackCanCastleKingside;
     bool blackCanCastleQueenside;
-    
-    Position enPassantTarget;
-    int halfMoveClock; // for 50-move rule
-    int fullMoveNumber;
-    std::shared_ptr<King> whiteKing;
-    std::shared_ptr<King> blackKing;
+
+    // En passant target square, or -1
+    int8_t enPassantSquare;
 
 public:
     Board();
@@ -35,11 +65,29 @@ public:
     // Get the current FEN representation of the board
     std::string toFEN() const;
     
-    // Get a piece at a specific position, or nullptr if empty
+    // Get a piece at a specific position, or nullptr if empty.
+    // The returned object is a shared read-only view built from the bitboards;
+    // modifying it does not change the board (use setPieceAt instead).
     std::shared_ptr<Piece> getPieceAt(const Position& pos) const;
     
-    // Set a piece at a specific position
+    // Set a piece at a specific position (nullptr clears the square)
     void setPieceAt(const Position& pos, std::shared_ptr<Piece> piece);
+
+    // Bitboard accessors
+    Bitboard getPieces(Color color, PieceType type) const { return typeBB[static_cast<int>(type)] & colorBB[colorIndex(color)]; }
+    Bitboard getPieces(Color color) const { return colorBB[colorIndex(color)]; }
+    Bitboard getOccupied() const { return colorBB[0] | colorBB[1]; }
+
+    // Mailbox accessors (square = row * 8 + col)
+    PieceType getPieceTypeAt(int square) const;
+    Color getPieceColorAt(int square) const;
+    bool isEmpty(int square) const { return mailbox[square] == NO_PIECE; }
+
+    // Square of the king of the given color, or -1 if there is none
+    int getKingSquare(Color color) const;
+
+    // All pieces of both colors attacking a square, for the given occupancy
+    Bitboard attackersTo(int square, Bitboard occupied) const;
     
  // Method declarations for Board class
 bool makeMove(const Move& move);
@@ -47,11 +95,46 @@ bool makeMove(const Move& move, BoardState& previousState);
 bool unmakeMove(const Move& move, const BoardState& previousState);
     
     // Generate all legal moves for the current side to move
-    std::vector<Move> generateLegalMoves() const;
+    MoveList generateLegalMoves() const;
+
+    // Generate pseudo-legal moves (may leave the king in check). Search plays them
+    // with makePseudoLegalMove, which verifies legality lazily.
+    void generatePseudoLegalMoves(MoveList& moves) const;
+
+    // The two halves of generatePseudoLegalMoves, for staged move ordering
+    void generateCaptures(MoveList& moves) const;
+    void generateQuiets(MoveList& moves) const;
+
+    // The legal moves of a position in check, built from the checker and pin
+    // masks: king steps to safe squares and, in single check, captures of the
+    // checker and blocks
+    void generateEvasions(MoveList& moves) const;
+
+    // Whether move could have come from generatePseudoLegalMoves in this
+    // position (flags included). Used to vet moves remembered from other
+    // positions, such as TT and killer moves, before playing them.
+    bool isPseudoLegal(const Move& move) const;
+
+    // Search fast path: play a move produced by one of the generators without
+    // re-validating it. If it leaves the mover's king in check the move is taken
+    // back and false is returned.
+    bool makePseudoLegalMove(const Move& move, BoardState& previousState);
+
+    // Hash and pawn keys of the position after a pseudo-legal move, computed
+    // without making it, so the search can prefetch the child's table entries
+    // while the move is still being made.
+    void keysAfter(const Move& move, uint64_t& key, uint64_t& childPawnKey) const;
+
+    // Our pieces that are pinned to our king
+    Bitboard getPinnedPieces(Color color) const;
     
     // Check if the current side to move is in check
     bool isInCheck() const;
     
+    // Whether the side to move has any legal move. Tries the king's own steps
+    // first, so it usually answers without generating the other moves.
+    bool hasLegalMove() const;
+
     // Check if the current side to move is in checkmate
     bool isCheckmate() const;
     
@@ -75,7 +158,23 @@ GameEndType getGameEndType() const;
     Color getSideToMove() const { return sideToMove; }
     
     // Switch the side to move
-    void switchSideToMove() { sideToMove = (sideToMove == Color::WHITE) ? Color::BLACK : Color::WHITE; }
+    void switchSideToMove() {
+        sideToMove = (sideToMove == Color::WHITE) ? Color::BLACK : Color::WHITE;
+        hashKey ^= Zobrist::sideToMoveKey();
+    }
+
+    // Zobrist key of the current position (maintained incrementally)
+    uint64_t getHashKey() const { return hashKey; }
+
+    // Zobrist key of the pawn placement only (maintained incrementally)
+    uint64_t getPawnKey() const { return pawnKey; }
+
+    // Incrementally maintained evaluation terms
+    int getMaterial(Color color) const { return material[colorIndex(color)]; }
+    int getPsqScore(Color color, bool endgame) const {
+        return psq[endgame ? PSQT::ENDGAME : PSQT::MIDDLEGAME][colorIndex(color)];
+    }
+    int getPhase() const { return phase; }
     
     // Check if a square is attacked by a piece of the specified color
     bool isSquareAttacked(const Position& pos, Color attackerColor) const;
@@ -87,7 +186,9 @@ GameEndType getGameEndType() const;
     bool getBlackCanCastleQueenside() const { return blackCanCastleQueenside; }
     
     // En passant target accessor
-    Position getEnPassantTarget() const { return enPassantTarget; }
+    Position getEnPassantTarget() const {
+        return enPassantSquare >= 0 ? Bitboards::fromSquare(enPassantSquare) : Position();
+    }
     
     // Print the board to the console
     void print() const;
@@ -96,6 +197,27 @@ GameEndType getGameEndType() const;
     void clear();
     
 private:
+    static const uint8_t NO_PIECE = 0xFF;
+
+    static int colorIndex(Color color) { return color == Color::WHITE ? 0 : 1; }
+
+    // Castling rights as a 4-bit mask (WK, WQ, BK, BQ) for Zobrist::castlingKey
+    int castlingRights() const;
+
+    // Key contribution of everything but the pieces: side, castling, en passant
+    uint64_t stateKey() const;
+
+    // Low-level placement helpers; keep bitboards and mailbox in sync
+    void putPiece(int square, Color color, PieceType type);
+    void removePiece(int square);
+
+    // Apply a move without any legality checks
+    void applyMove(const Move& move, BoardState& previousState);
+
+    // Move generation core: pseudo-legal, or fully legal using check and pin masks
+    void generateMoves(MoveList& moves, bool legalOnly, MoveGenType type = MoveGenType::ALL) const;
+    bool isEnPassantLegal(int from, int to, int capturedSquare) const;
+
     // Check if a castling move is legal
     bool canCastle(const Move& move) const;
 
@@ -104,17 +226,7 @@ bool isValidMovePattern(std::shared_ptr<Piece> piece, const Move& move) const;
 
 bool validateFENBoardString(const std::string& boardStr) const;
 
-    bool canPieceAttackSquare(std::shared_ptr<Piece> piece, const Position& from, const Position& target) const;
     bool isPathClear(const Position& from, const Position& to) const;
-
-    // Add these to board.h in the private section:
-bool canPieceAttackSquareAfterMove(std::shared_ptr<Piece> piece, Position piecePos, 
-                                  Position target, const Move& simulatedMove) const;
-bool canPieceAttackSquareSimple(PieceType pieceType, Position from, Position to) const;
-bool isPathClearForMove(Position from, Position to) const;
-    
-    // Helper to verify king safety after move
-    bool wouldBeInCheck(const Move& move, Color kingColor) const;
 };
 
 #endif // BOARD_H
\ No newline at end of file
@@ -3,22 +3,23 @@
 
 #include "common.h"
 #include "piece.h"
+#include <cstdint>
 
-// Structure to store board state for move reversal
+// Structure to store board state for move reversal. A plain value with no
+// owned pieces, so the search can keep a fixed stack of them per thread.
 struct BoardState {
     Color sideToMove;
     bool whiteCanCastleKingside;
     bool whiteCanCastleQueenside;
     bool blackCanCastleKingside;
     bool blackCanCastleQueenside;
-    Position enPassantTarget;
+    int8_t enPassantSquare; // -1 if none
     int halfMoveClock;
     int fullMoveNumber;
-    std::shared_ptr<Piece> capturedPiece;
+    uint64_t hashKey;
+    PieceType capturedType; // NONE if the move captured nothing; the color is the opponent's
     bool wasEnPassant;
     bool wasPromotion;
-    PieceType originalType;
-    bool pieceHasMoved;
     
     BoardState() : 
         sideToMove(Color::WHITE), 
@@ -26,58 +27,13 @@ struct BoardState {
         whiteCanCastleQueenside(false),
         blackCanCastleKingside(false),
         blackCanCastleQueenside(false),
-        enPassantTarget(Position()),
+        enPassantSquare(-1),
         halfMoveClock(0),
         fullMoveNumber(1),
-        capturedPiece(nullptr),
+        hashKey(0),
+        capturedType(PieceType::NONE),
         wasEnPassant(false),
-        wasPromotion(false),
-        originalType(PieceType::NONE),
-        pieceHasMoved(false) {}
-    
-    // CRITICAL FIX: Add destructor to ensure proper cleanup
-    ~BoardState() {
-        // Explicitly reset shared_ptr to ensure cleanup
-        if (capturedPiece) {
-            capturedPiece.reset();
-        }
-    }
-    
-    // CRITICAL FIX: Add copy constructor for safe copying
-    BoardState(const BoardState& other) :
-        sideToMove(other.sideToMove),
-        whiteCanCastleKingside(other.whiteCanCastleKingside),
-        whiteCanCastleQueenside(other.whiteCanCastleQueenside),
-        blackCanCastleKingside(other.blackCanCastleKingside),
-        blackCanCastleQueenside(other.blackCanCastleQueenside),
-        enPassantTarget(other.enPassantTarget),
-        halfMoveClock(other.halfMoveClock),
-        fullMoveNumber(other.fullMoveNumber),
-        capturedPiece(other.capturedPiece), // shared_ptr handles reference counting
-        wasEnPassant(other.wasEnPassant),
-        wasPromotion(other.wasPromotion),
-        originalType(other.originalType),
-        pieceHasMoved(other.pieceHasMoved) {}
-    
-    // CRITICAL FIX: Add assignment operator
-    BoardState& operator=(const BoardState& other) {
-        if (this != &other) {
-            sideToMove = other.sideToMove;
-            whiteCanCastleKingside = other.whiteCanCastleKingside;
-            whiteCanCastleQueenside = other.whiteCanCastleQueenside;
-            blackCanCastleKingside = other.blackCanCastleKingside;
-            blackCanCastleQueenside = other.blackCanCastleQueenside;
-            enPassantTarget = other.enPassantTarget;
-            halfMoveClock = other.halfMoveClock;
-            fullMoveNumber = other.fullMoveNumber;
-            capturedPiece = other.capturedPiece;
-            wasEnPassant = other.wasEnPassant;
-            wasPromotion = other.wasPromotion;
-            originalType = other.originalType;
-            pieceHasMoved = other.pieceHasMoved;
-        }
-        return *this;
-    }
+        wasPromotion(false) {}
 };
 
 #endif // BOARD_STATE_H
\ No newline at end of file
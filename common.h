@@ -9,6 +9,9 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#ifdef _MSC_VER
+#include <xmmintrin.h>
+#endif
 
 // Forward declarations
 class Board;
@@ -18,4 +21,16 @@ class Game;
 class Engine;
 class TranspositionTable;
 
+// Start loading the cache line holding address without waiting for it
+inline void prefetchLine(const void *address)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER)
+    _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
 #endif // COMMON_H
\ No newline at end of file
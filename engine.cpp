@@ -4,101 +4,64 @@
 #include <algorithm>
 #include <sstream>
 
-// CRITICAL FIX: Add bounds checking macros for all array accesses
-#define SAFE_PLY_ACCESS(ply) (((ply) >= 0 && (ply) < MAX_PLY) ? (ply) : 0)
-#define SAFE_ARRAY_ACCESS(index, max_size) (((index) >= 0 && (index) < (max_size)) ? (index) : 0)
-
-// Initialize piece-square tables
-// These tables provide positional bonuses for pieces on specific squares
-const int Engine::pawnTable[64] = {
-    0, 0, 0, 0, 0, 0, 0, 0,
-    50, 50, 50, 50, 50, 50, 50, 50,
-    10, 10, 20, 30, 30, 20, 10, 10,
-    5, 5, 10, 25, 25, 10, 5, 5,
-    0, 0, 0, 20, 20, 0, 0, 0,
-    5, -5, -10, 0, 0, -10, -5, 5,
-    5, 10, 10, -20, -20, 10, 10, 5,
-    0, 0, 0, 0, 0, 0, 0, 0};
-
-const int Engine::knightTable[64] = {
-    -50, -40, -30, -30, -30, -30, -40, -50,
-    -40, -20, 0, 0, 0, 0, -20, -40,
-    -30, 0, 10, 15, 15, 10, 0, -30,
-    -30, 5, 15, 20, 20, 15, 5, -30,
-    -30, 0, 15, 20, 20, 15, 0, -30,
-    -30, 5, 10, 15, 15, 10, 5, -30,
-    -40, -20, 0, 5, 5, 0, -20, -40,
-    -50, -40, -30, -30, -30, -30, -40, -50};
-
-const int Engine::bishopTable[64] = {
-    -20, -10, -10, -10, -10, -10, -10, -20,
-    -10, 0, 0, 0, 0, 0, 0, -10,
-    -10, 0, 10, 10, 10, 10, 0, -10,
-    -10, 5, 5, 10, 10, 5, 5, -10,
-    -10, 0, 5, 10, 10, 5, 0, -10,
-    -10, 5, 5, 5, 5, 5, 5, -10,
-    -10, 0, 5, 0, 0, 5, 0, -10,
-    -20, -10, -10, -10, -10, -10, -10, -20};
-
-const int Engine::rookTable[64] = {
-    0, 0, 0, 0, 0, 0, 0, 0,
-    5, 10, 10, 10, 10, 10, 10, 5,
-    -5, 0, 0, 0, 0, 0, 0, -5,
-    -5, 0, 0, 0, 0, 0, 0, -5,
-    -5, 0, 0, 0, 0, 0, 0, -5,
-    -5, 0, 0, 0, 0, 0, 0, -5,
-    -5, 0, 0, 0, 0, 0, 0, -5,
-    0, 0, 0, 5, 5, 0, 0, 0};
-
-const int Engine::queenTable[64] = {
-    -20, -10, -10, -5, -5, -10, -10, -20,
-    -10, 0, 0, 0, 0, 0, 0, -10,
-    -10, 0, 5, 5, 5, 5, 0, -10,
-    -5, 0, 5, 5, 5, 5, 0, -5,
-    0, 0, 5, 5, 5, 5, 0, -5,
-    -10, 5, 5, 5, 5, 5, 0, -10,
-    -10, 0, 5, 0, 0, 0, 0, -10,
-    -20, -10, -10, -5, -5, -10, -10, -20};
-
-const int Engine::kingMiddleGameTable[64] = {
-    -30, -40, -40, -50, -50, -40, -40, -30,
-    -30, -40, -40, -50, -50, -40, -40, -30,
-    -30, -40, -40, -50, -50, -40, -40, -30,
-    -30, -40, -40, -50, -50, -40, -40, -30,
-    -20, -30, -30, -40, -40, -30, -30, -20,
-    -10, -20, -20, -20, -20, -20, -20, -10,
-    20, 20, 0, 0, 0, 0, 20, 20,
-    20, 30, 10, 0, 0, 10, 30, 20};
-
-const int Engine::kingEndGameTable[64] = {
-    -50, -40, -30, -20, -20, -30, -40, -50,
-    -30, -20, -10, 0, 0, -10, -20, -30,
-    -30, -10, 20, 30, 30, 20, -10, -30,
-    -30, -10, 30, 40, 40, 30, -10, -30,
-    -30, -10, 30, 40, 40, 30, -10, -30,
-    -30, -10, 20, 30, 30, 20, -10, -30,
-    -30, -30, 0, 0, 0, 0, -30, -30,
-    -50, -30, -30, -30, -30, -30, -30, -50};
+// Out-of-class definitions for constants whose address is taken (std::min/std::max, tuning)
+const int Engine::NULL_MOVE_MIN_DEPTH;
+const int Engine::MAX_EXTENSIONS_PER_PLY;
+const int Engine::MAX_TOTAL_EXTENSIONS;
+const int Engine::LMR_MIN_DEPTH;
+const int Engine::LMR_MIN_MOVE_INDEX;
+const int Engine::MAX_LMR_REDUCTION;
+const int Engine::MIN_LMR_REDUCTION;
 
 // Engine Constructor - ADD THIS ENTIRE BLOCK
 Engine::Engine(Game &g, int depth, int ttSizeMB, bool useTimeManagement)
-    : game(g), 
-      maxDepth(depth),
-      transpositionTable(),
-      zobristHasher(),
+    : Engine(g, depth, std::make_shared<TranspositionTable>(ttSizeMB)) {
+    timeManaged = useTimeManagement;
+}
+
+Engine::Engine(Game &g, int depth, std::shared_ptr<TranspositionTable> sharedTT)
+    : maxDepth(depth),
+      game(g),
+      transpositionTable(std::move(sharedTT)),
+      helperIndex(0),
+      completedScore(0),
+      completedDepth(0),
+      pvTable(MAX_PLY),
       nodesSearched(0),
       totalExtensionsInPath(0) {
     
     std::cout << "Engine: Starting initialization..." << std::endl;
     
-    // ALLOCATE HUGE ARRAY DYNAMICALLY TO AVOID STACK OVERFLOW
-    counterMovesPtr = new Move[6 * 2 * 64 * 64]();
-    std::cout << "Engine: Allocated counterMoves array" << std::endl;
+    initializeTables();
+    
+    std::cout << "Engine: Constructor completed successfully!" << std::endl;
+}
+
+// Helper engine for Lazy SMP: same tables, shared TT, no console output
+Engine::Engine(Game &g, int depth, std::shared_ptr<TranspositionTable> sharedTT, int index)
+    : maxDepth(depth),
+      game(g),
+      transpositionTable(std::move(sharedTT)),
+      helperIndex(index),
+      completedScore(0),
+      completedDepth(0),
+      pvTable(MAX_PLY),
+      nodesSearched(0),
+      totalExtensionsInPath(0) {
+    initializeTables();
+}
+
+void Engine::initializeTables()
+{
+    pawnHashTable.reset(new PawnHashTable());
+    counterMoves.reset(new Move[COUNTER_MOVE_ENTRIES]);
+    historyTable.reset(new int[2][64][64]);
+    butterflyHistory.reset(new int[64][64]);
     
     // Initialize all arrays
     for (int i = 0; i < MAX_PLY; i++) {
         for (int j = 0; j < 4; j++) {
-            killerMoves[i][j] = Move(Position(0,0), Position(0,0));
+            killerMoves[i][j] = Move();
         }
         nullMoveAllowed[i] = true;
         extensionsUsed[i] = 0;
@@ -123,20 +86,38 @@ Engine::Engine(Game &g, int depth, int ttSizeMB, bool useTimeManagement)
     
     for (int i = 0; i < 6; i++) {
         for (int j = 0; j < 64; j++) {
-            countermoveHistory[i][j] = Move(Position(0,0), Position(0,0));
+            countermoveHistory[i][j] = Move();
         }
     }
     
     for (int i = 0; i < 5; i++) {
         pruningStats[i] = 0;
     }
+    pawnHashTable->resetStats();
     
-    std::cout << "Engine: Constructor completed successfully!" << std::endl;
+    // Time management starts off; setTimeForMove/setTimeManagement turn it on
+    timeAllocated = 0;
+    timeBuffer = 0;
+    timeManaged = false;
+    positionIsUnstable = false;
+    unstableExtensionPercent = 50;
+
+    nodeLimit = 0;
+    mateLimit = 0;
+    prefetchEnabled = true;
+    quiet = false;
+    selDepth = 0;
+    currentIterationDepth = 0;
 }
 
-// Engine Destructor - ADD THIS TOO
-Engine::~Engine() {
-    delete[] counterMovesPtr;
+void Engine::resetHeuristics()
+{
+    clearKillerMoves();
+    clearCounterMoves();
+    clearHistoryTable();
+    clearEnhancedTables();
+    clearSearchLimits();
+    principalVariation.clear();
 }
 
 void Engine::clearKillerMoves() {
@@ -144,7 +125,7 @@ void Engine::clearKillerMoves() {
     {
         for (int i = 0; i < 4; i++) // 4 killer slots instead of 2
         {
-            killerMoves[ply][i] = Move(Position(0, 0), Position(0, 0));
+            killerMoves[ply][i] = Move();
         }
     }
 }
@@ -152,9 +133,9 @@ void Engine::clearKillerMoves() {
 // Clear the counter moves
 void Engine::clearCounterMoves()
 {
-    for (int i = 0; i < 6 * 2 * 64 * 64; i++)
+    for (int i = 0; i < COUNTER_MOVE_ENTRIES; i++)
     {
-        counterMovesPtr[i] = Move(Position(0, 0), Position(0, 0));
+        counterMoves[i] = Move();
     }
 }
 
@@ -170,295 +151,16 @@ void Engine::clearEnhancedTables()
     // Clear countermove history
     for (int piece = 0; piece < 6; piece++) {
         for (int to = 0; to < 64; to++) {
-            countermoveHistory[piece][to] = Move(Position(0, 0), Position(0, 0));
+            countermoveHistory[piece][to] = Move();
         }
     }
     
-    // Clear SEE cache
-    clearSEECache();
-    
     // Reset null move tracking
     for (int i = 0; i < MAX_PLY; i++) {
         nullMoveAllowed[i] = true;
     }
 }
 
-// Clear SEE Cache
-void Engine::clearSEECache()
-{
-    seeCache.clear();
-}
-
-// Generate capture moves
-void Engine::generateCaptureMoves(const Board& board, std::vector<Move>& captures) const
-{
-    captures.clear();
-    
-    Color sideToMove = board.getSideToMove();
-    
-    // Loop through all squares to find our pieces
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            Position from(row, col);
-            auto piece = board.getPieceAt(from);
-            
-            if (!piece || piece->getColor() != sideToMove) continue;
-            
-            // Generate captures for each piece type
-            switch (piece->getType()) {
-                case PieceType::PAWN:
-                    generatePawnCaptures(board, from, captures);
-                    break;
-                    
-                case PieceType::KNIGHT:
-                    generateKnightCaptures(board, from, captures);
-                    break;
-                    
-                case PieceType::BISHOP:
-                    generateBishopCaptures(board, from, captures);
-                    break;
-                    
-                case PieceType::ROOK:
-                    generateRookCaptures(board, from, captures);
-                    break;
-                    
-                case PieceType::QUEEN:
-                    generateQueenCaptures(board, from, captures);
-                    break;
-                    
-                case PieceType::KING:
-                    generateKingCaptures(board, from, captures);
-                    break;
-                    
-                default:
-                    break;
-            }
-        }
-    }
-}
-
-void Engine::generatePawnCaptures(const Board& board, Position from, std::vector<Move>& captures) const
-{
-    auto piece = board.getPieceAt(from);
-    if (!piece || piece->getType() != PieceType::PAWN) return;
-    
-    Color color = piece->getColor();
-    int direction = (color == Color::WHITE) ? 1 : -1;
-    
-    // Diagonal captures
-    for (int dCol : {-1, 1}) {
-        Position to(from.row + direction, from.col + dCol);
-        
-        if (!to.isValid()) continue;
-        
-        auto target = board.getPieceAt(to);
-        
-        // Regular capture
-        if (target && target->getColor() != color) {
-            // Check for promotion
-            if (to.row == 0 || to.row == 7) {
-                captures.emplace_back(from, to, PieceType::QUEEN);
-                captures.emplace_back(from, to, PieceType::ROOK);
-                captures.emplace_back(from, to, PieceType::BISHOP);
-                captures.emplace_back(from, to, PieceType::KNIGHT);
-            } else {
-                captures.emplace_back(from, to);
-            }
-        }
-        // En passant capture
-        else if (to == board.getEnPassantTarget()) {
-            captures.emplace_back(from, to);
-        }
-    }
-}
-
-void Engine::generateKnightCaptures(const Board& board, Position from, std::vector<Move>& captures) const
-{
-    auto piece = board.getPieceAt(from);
-    if (!piece || piece->getType() != PieceType::KNIGHT) return;
-    
-    Color color = piece->getColor();
-    const std::vector<std::pair<int, int>> knightMoves = {
-        {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
-        {1, -2}, {1, 2}, {2, -1}, {2, 1}
-    };
-    
-    for (const auto& offset : knightMoves) {
-        Position to(from.row + offset.first, from.col + offset.second);
-        
-        if (!to.isValid()) continue;
-        
-        auto target = board.getPieceAt(to);
-        if (target && target->getColor() != color) {
-            captures.emplace_back(from, to);
-        }
-    }
-}
-
-void Engine::generateBishopCaptures(const Board& board, Position from, std::vector<Move>& captures) const
-{
-    auto piece = board.getPieceAt(from);
-    if (!piece || piece->getType() != PieceType::BISHOP) return;
-    
-    Color color = piece->getColor();
-    const std::vector<std::pair<int, int>> directions = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
-    
-    for (const auto& dir : directions) {
-        for (int distance = 1; distance < 8; distance++) {
-            Position to(from.row + dir.first * distance, from.col + dir.second * distance);
-            
-            if (!to.isValid()) break;
-            
-            auto target = board.getPieceAt(to);
-            if (target) {
-                if (target->getColor() != color) {
-                    captures.emplace_back(from, to);
-                }
-                break; // Can't go further
-            }
-        }
-    }
-}
-
-void Engine::generateRookCaptures(const Board& board, Position from, std::vector<Move>& captures) const
-{
-    auto piece = board.getPieceAt(from);
-    if (!piece || piece->getType() != PieceType::ROOK) return;
-    
-    Color color = piece->getColor();
-    const std::vector<std::pair<int, int>> directions = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
-    
-    for (const auto& dir : directions) {
-        for (int distance = 1; distance < 8; distance++) {
-            Position to(from.row + dir.first * distance, from.col + dir.second * distance);
-            
-            if (!to.isValid()) break;
-            
-            auto target = board.getPieceAt(to);
-            if (target) {
-                if (target->getColor() != color) {
-                    captures.emplace_back(from, to);
-                }
-                break; // Can't go further
-            }
-        }
-    }
-}
-
-void Engine::generateQueenCaptures(const Board& board, Position from, std::vector<Move>& captures) const
-{
-    // Queen moves like both rook and bishop
-    generateRookCaptures(board, from, captures);
-    generateBishopCaptures(board, from, captures);
-}
-
-void Engine::generateKingCaptures(const Board& board, Position from, std::vector<Move>& captures) const
-{
-    auto piece = board.getPieceAt(from);
-    if (!piece || piece->getType() != PieceType::KING) return;
-    
-    Color color = piece->getColor();
-    const std::vector<std::pair<int, int>> directions = {
-        {-1, -1}, {-1, 0}, {-1, 1},
-        {0, -1},           {0, 1},
-        {1, -1},  {1, 0},  {1, 1}
-    };
-    
-    for (const auto& dir : directions) {
-        Position to(from.row + dir.first, from.col + dir.second);
-        
-        if (!to.isValid()) continue;
-        
-        auto target = board.getPieceAt(to);
-        if (target && target->getColor() != color) {
-            captures.emplace_back(from, to);
-        }
-    }
-}
-
-void Engine::generateCheckEvasions(const Board& board, std::vector<Move>& evasions) const
-{
-    evasions.clear();
-    
-    Color sideToMove = board.getSideToMove();
-    
-    // Find the king's actual position
-    Position kingPos;
-    bool foundKing = false;
-    for (int row = 0; row < 8 && !foundKing; row++) {
-        for (int col = 0; col < 8 && !foundKing; col++) {
-            auto piece = board.getPieceAt(Position(row, col));
-            if (piece && piece->getType() == PieceType::KING && piece->getColor() == sideToMove) {
-                kingPos = Position(row, col);
-                foundKing = true;
-            }
-        }
-    }
-    
-    if (!foundKing) return;
-    
-    // 1. Generate king moves (always try to move the king out of check)
-    const std::vector<std::pair<int, int>> kingMoves = {
-        {-1, -1}, {-1, 0}, {-1, 1},
-        {0, -1},           {0, 1},
-        {1, -1},  {1, 0},  {1, 1}
-    };
-    
-    for (const auto& offset : kingMoves) {
-        Position to(kingPos.row + offset.first, kingPos.col + offset.second);
-        if (to.isValid()) {
-            auto target = board.getPieceAt(to);
-            if (!target || target->getColor() != sideToMove) {
-                evasions.emplace_back(kingPos, to);
-            }
-        }
-    }
-    
-    // 2. Try to block or capture the attacking piece
-    // For now, generate all legal moves as fallback (this could be optimized further)
-    auto allMoves = board.generateLegalMoves();
-    for (const auto& move : allMoves) {
-        // Skip king moves (already added above)
-        auto piece = board.getPieceAt(move.from);
-        if (piece && piece->getType() != PieceType::KING) {
-            evasions.push_back(move);
-        }
-    }
-}
-
-void Engine::generatePromotions(const Board& board, std::vector<Move>& promotions) const
-{
-    Color sideToMove = board.getSideToMove();
-    int promotionRank = (sideToMove == Color::WHITE) ? 6 : 1; // 7th rank for promotion
-    
-    for (int col = 0; col < 8; col++) {
-        Position pawnPos(promotionRank, col);
-        auto piece = board.getPieceAt(pawnPos);
-        
-        if (piece && piece->getType() == PieceType::PAWN && piece->getColor() == sideToMove) {
-            int direction = (sideToMove == Color::WHITE) ? 1 : -1;
-            Position to(pawnPos.row + direction, pawnPos.col);
-            
-            // Forward promotion
-            if (to.isValid() && !board.getPieceAt(to)) {
-                promotions.emplace_back(pawnPos, to, PieceType::QUEEN);
-                // Only add queen promotions in quiescence (most important)
-            }
-            
-            // Capture promotions
-            for (int dCol : {-1, 1}) {
-                Position captureTo(pawnPos.row + direction, pawnPos.col + dCol);
-                if (captureTo.isValid()) {
-                    auto target = board.getPieceAt(captureTo);
-                    if (target && target->getColor() != sideToMove) {
-                        promotions.emplace_back(pawnPos, captureTo, PieceType::QUEEN);
-                    }
-                }
-            }
-        }
-    }
-}
-
 // Clear the history table
 void Engine::clearHistoryTable()
 {
@@ -603,8 +305,8 @@ int Engine::getTacticalPositionBonus(const Board& board) const
     int bonus = 0;
     
     // Count available captures
-    std::vector<Move> captures;
-    generateCaptureMoves(board, captures);
+    MoveList captures;
+    board.generateCaptures(captures);
     
     if (captures.size() > 3) {
         bonus += 2; // Many captures = tactical
@@ -654,7 +356,7 @@ int Engine::getTacticalPositionBonus(const Board& board) const
 
 int Engine::getKingSafetyBonus(const Board& board, const Move& move) const
 {
-    auto movingPiece = board.getPieceAt(move.from);
+    auto movingPiece = board.getPieceAt(move.from());
     if (!movingPiece) return 0;
     
     // Moving pieces away from our king = dangerous
@@ -676,8 +378,8 @@ int Engine::getKingSafetyBonus(const Board& board, const Move& move) const
     if (!foundKing) return 0;
     
     // Calculate distance from king before and after move
-    int distBefore = abs(move.from.row - ourKingPos.row) + abs(move.from.col - ourKingPos.col);
-    int distAfter = abs(move.to.row - ourKingPos.row) + abs(move.to.col - ourKingPos.col);
+    int distBefore = abs(move.from().row - ourKingPos.row) + abs(move.from().col - ourKingPos.col);
+    int distAfter = abs(move.to().row - ourKingPos.row) + abs(move.to().col - ourKingPos.col);
     
     // Moving away from king in critical positions = reduce less
     if (distAfter > distBefore && distBefore <= 3) {
@@ -713,20 +415,19 @@ int Engine::calculateExtensions(const Move& move, const Board& board, int depth,
     }
     
     // 3. Recapture Extension
-    if (move.to.isValid()) {
-        auto capturedPiece = board.getPieceAt(move.to);
-        if (capturedPiece && totalExtensionsInPath < MAX_TOTAL_EXTENSIONS / 2) {
+    if (move.isCapture()) {
+        if (totalExtensionsInPath < MAX_TOTAL_EXTENSIONS / 2) {
             totalExtension = std::max(totalExtension, 1);
         }
     }
     
     // 4. Pawn Push to 7th Rank Extension
-    auto movingPiece = board.getPieceAt(move.from);
+    auto movingPiece = board.getPieceAt(move.from());
     if (movingPiece && movingPiece->getType() == PieceType::PAWN) {
         Color pawnColor = movingPiece->getColor();
         int promotionRank = (pawnColor == Color::WHITE) ? 6 : 1;
         
-        if (move.to.row == promotionRank && totalExtensionsInPath < MAX_TOTAL_EXTENSIONS / 2) {
+        if (move.to().row == promotionRank && totalExtensionsInPath < MAX_TOTAL_EXTENSIONS / 2) {
             totalExtension = std::max(totalExtension, 1);
         }
     }
@@ -776,7 +477,7 @@ int Engine::getSingularExtension(const Board& board, const Move& move, int depth
 // Store PV at a specific depth
 
 // Store PV at a specific depth
-void Engine::storePV(int depth, const std::vector<Move> &pv)
+void Engine::storePV(int depth, const PVLine &pv)
 {
     if (depth >= 0 && depth < MAX_PLY)
     {
@@ -793,30 +494,48 @@ bool Engine::isPVMove(const Move &move, int depth, int ply) const
     }
 
     const Move &pvMove = pvTable[depth][ply];
-    return (pvMove.from.row == move.from.row &&
-            pvMove.from.col == move.from.col &&
-            pvMove.to.row == move.to.row &&
-            pvMove.to.col == move.to.col);
+    return (pvMove == move);
 }
 
 // Get the best move for the current position
-Move Engine::getBestMove()
+Move Engine::getBestMove(bool keepPendingStop)
 {
-    // Reset search statistics
-    resetStats();
-    // Reset search flags at start of new search
-    searchShouldStop.store(false);
+    if (!keepPendingStop)
+    {
+        searchShouldStop.store(false);
+    }
+    prepareSearch();
     timeManagementActive.store(timeManaged);
     searchStartTime = std::chrono::high_resolution_clock::now();
 
-    // Get a copy of the board
-    Board board = game.getBoard();
+    // Search on this engine's own board; Board is a plain value, so the copy is cheap
+    searchBoard = game.getBoard();
 
     // Increment transposition table age
-    transpositionTable.incrementAge();
+    transpositionTable->incrementAge();
+
+    // The board carries its own Zobrist key
+    uint64_t hashKey = searchBoard.getHashKey();
+
+    if (!helpers.empty())
+    {
+        return lazySMPSearch(searchBoard, hashKey);
+    }
+
+    // Use iterative deepening to find the best move
+    return iterativeDeepeningSearch(searchBoard, maxDepth, hashKey);
+}
 
-    // Initialize Zobrist hashing
-    uint64_t hashKey = zobristHasher.generateHashKey(board);
+void Engine::prepareSearch()
+{
+    // Reset search statistics
+    resetStats();
+    completedBestMove = Move();
+    completedScore = 0;
+    completedDepth = 0;
+    selDepth = 0;
+    currentIterationDepth = 0;
+    lastProgressReport = std::chrono::high_resolution_clock::now();
 
    // Reset null move tracking for new search
     for (int i = 0; i < MAX_PLY; i++) {
@@ -836,17 +555,175 @@ Move Engine::getBestMove()
     for (int i = 0; i < 5; i++) {
         pruningStats[i] = 0;
     }
+}
 
-    // Use iterative deepening to find the best move
-    return iterativeDeepeningSearch(board, maxDepth, hashKey);
+void Engine::clearSearchLimits()
+{
+    timeManaged = false;
+    timeAllocated = 0;
+    nodeLimit = 0;
+    mateLimit = 0;
+}
+
+void Engine::ponderHit(int timeMs)
+{
+    // Set the budget before switching the clock on so the search never sees
+    // time management enabled with a stale allocation
+    timeAllocated = timeMs;
+    timeManaged = true;
+}
+
+void Engine::reportProgress(int depth, int score, bool iterationComplete, ScoreBound bound, const PVLine *pv)
+{
+    auto now = std::chrono::high_resolution_clock::now();
+    lastProgressReport = now;
+
+    SearchInfo info;
+    info.depth = depth;
+    info.selDepth = std::max(selDepth, depth);
+    info.score = score;
+    info.bound = bound;
+    info.nodes = nodesSearched;
+    info.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - searchStartTime).count();
+    info.nps = info.timeMs > 0 ? static_cast<long>(nodesSearched * 1000.0 / info.timeMs) : 0;
+    info.hashfull = transpositionTable->hashfull();
+    if (iterationComplete)
+    {
+        info.pv = principalVariation;
+    }
+    else if (pv)
+    {
+        info.pv = *pv;
+    }
+    info.iterationComplete = iterationComplete;
+
+    searchListener(info);
+}
+
+void Engine::setThreads(int threads)
+{
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    helpers.clear();
+    for (int i = 1; i < threads; i++)
+    {
+        helpers.emplace_back(new Engine(game, maxDepth, transpositionTable, i));
+        helpers.back()->setPawnHashSize(pawnHashTable->getSizeMB());
+        helpers.back()->prefetchEnabled = prefetchEnabled;
+    }
+}
+
+void Engine::setPrefetch(bool enabled)
+{
+    prefetchEnabled = enabled;
+    for (auto &helper : helpers)
+    {
+        helper->prefetchEnabled = enabled;
+    }
+}
+
+void Engine::setPawnHashSize(int sizeMB)
+{
+    pawnHashTable->resize(sizeMB);
+    for (auto &helper : helpers)
+    {
+        helper->pawnHashTable->resize(sizeMB);
+    }
+}
+
+double Engine::getPawnHashHitRate() const
+{
+    long probes = pawnHashTable->getProbes();
+    return probes > 0 ? 100.0 * pawnHashTable->getHits() / probes : 0.0;
+}
+
+// Lazy SMP: every helper runs its own iterative deepening on a private copy of
+// the root, with its own killers and history, and they all share one TT. The
+// helpers mostly help by filling the TT for each other; odd-numbered helpers
+// aim one ply deeper so the threads do not all search in lockstep. When the
+// main thread finishes, the helpers are stopped and the best result is taken
+// from the deepest completed iteration, with ties settled by a vote.
+Move Engine::lazySMPSearch(Board &board, uint64_t hashKey)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(helpers.size());
+
+    for (auto &helper : helpers)
+    {
+        Engine *h = helper.get();
+        h->searchShouldStop.store(false);
+        h->prepareSearch();
+        h->maxDepth = maxDepth + (h->helperIndex % 2);
+        h->timeManaged = false;
+        h->searchStartTime = searchStartTime;
+        h->searchBoard = board;
+
+        threads.emplace_back([h]() {
+            h->iterativeDeepeningSearch(h->searchBoard, h->maxDepth, h->searchBoard.getHashKey());
+        });
+    }
+
+    Move mainMove = iterativeDeepeningSearch(board, maxDepth, hashKey);
+
+    for (auto &helper : helpers)
+    {
+        helper->searchShouldStop.store(true);
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    // Pick the deepest completed iteration; break ties by how many threads agree
+    const Engine *best = this;
+    int bestVotes = 0;
+    std::vector<const Engine *> engines;
+    engines.push_back(this);
+    for (const auto &helper : helpers)
+    {
+        engines.push_back(helper.get());
+        nodesSearched += helper->nodesSearched;
+    }
+
+    for (const Engine *candidate : engines)
+    {
+        if (candidate->completedBestMove.isNull())
+            continue;
+
+        int votes = 0;
+        for (const Engine *other : engines)
+        {
+            if (other->completedDepth == candidate->completedDepth &&
+                other->completedBestMove == candidate->completedBestMove)
+            {
+                votes++;
+            }
+        }
+
+        if (candidate->completedDepth > best->completedDepth ||
+            (candidate->completedDepth == best->completedDepth && votes > bestVotes))
+        {
+            best = candidate;
+            bestVotes = votes;
+        }
+    }
+
+    if (best == this || best->completedBestMove.isNull())
+    {
+        return mainMove;
+    }
+
+    principalVariation = best->principalVariation;
+    return best->completedBestMove;
 }
 
 // Iterative deepening search
 Move Engine::iterativeDeepeningSearch(Board &board, int maxDepth, uint64_t hashKey)
 {
     principalVariation.clear();
-    Move bestMove(Position(0, 0), Position(0, 0));
-    Move previousBestMove(Position(0, 0), Position(0, 0));
+    Move bestMove;
+    Move previousBestMove;
     int bestScore = 0;
     int previousScore = 0;
 
@@ -866,10 +743,12 @@ Move Engine::iterativeDeepeningSearch(Board &board, int maxDepth, uint64_t hashK
         pvTable[i].clear();
     }
 
-    // Iterative deepening loop
-    for (int depth = 1; depth <= maxDepth && !searchShouldStop.load(); depth++)
+    // Iterative deepening loop. Depth 1 always runs, even after an early stop,
+    // so there is a legal move to answer with.
+    for (int depth = 1; depth <= maxDepth && (depth == 1 || !searchShouldStop.load()); depth++)
     {
-        std::vector<Move> pv;
+        PVLine pv;
+        currentIterationDepth = depth;
 
         // Record nodes before this iteration
         nodesPrevious = nodesSearched;
@@ -889,7 +768,7 @@ Move Engine::iterativeDeepeningSearch(Board &board, int maxDepth, uint64_t hashK
         {
             alpha = -100000;
             beta = 100000;
-           score = pvSearch(board, depth, alpha, beta, maximizingPlayer, pv, hashKey, 0, Move(Position(0, 0), Position(0, 0)));
+           score = pvSearch(board, depth, alpha, beta, maximizingPlayer, pv, hashKey, 0, Move());
         }
         else
         {
@@ -900,25 +779,39 @@ Move Engine::iterativeDeepeningSearch(Board &board, int maxDepth, uint64_t hashK
             // Try with narrow window first
             while (true)
             {
-               score = pvSearch(board, depth, alpha, beta, maximizingPlayer, pv, hashKey, 0, Move(Position(0, 0), Position(0, 0)));
+               score = pvSearch(board, depth, alpha, beta, maximizingPlayer, pv, hashKey, 0, Move());
 
                 // If the score falls within our window, we're good
-                if (score > alpha && score < beta)
+                if ((score > alpha && score < beta) || searchShouldStop.load())
                 {
                     break;
                 }
 
+                // A bound already at the edge of the score range cannot be widened
+                // any further; re-searching would just repeat the same result
+                if ((score <= alpha && alpha <= -100000) || (score >= beta && beta >= 100000))
+                {
+                    break;
+                }
+
+                // Let the listener show the bound before the re-search, which
+                // can take much longer than the failed search did
+                if (helperIndex == 0 && searchListener)
+                {
+                    reportProgress(depth, score, false, score <= alpha ? ScoreBound::UPPER : ScoreBound::LOWER, &pv);
+                }
+
                 // If we failed low (score <= alpha), widen the window
                 if (score <= alpha)
                 {
                     alpha = std::max(-100000, alpha - delta);
-                    delta *= 2; // Increase window size
+                    delta = std::min(delta * 2, 200000); // Increase window size
                 }
                 // If we failed high (score >= beta), widen the window
                 else if (score >= beta)
                 {
                     beta = std::min(100000, beta + delta);
-                    delta *= 2; // Increase window size
+                    delta = std::min(delta * 2, 200000); // Increase window size
                 }
 
                 // If window is already full, break
@@ -929,12 +822,21 @@ Move Engine::iterativeDeepeningSearch(Board &board, int maxDepth, uint64_t hashK
             }
         }
 
+        // An iteration cut short by a stop request is incomplete; keep the last full one
+        if (searchShouldStop.load() && !bestMove.isNull())
+        {
+            break;
+        }
+
         // Store the best move and score if we got valid results
         if (!pv.empty())
         {
             bestMove = pv[0];
             bestScore = score;
             principalVariation = pv;
+            completedBestMove = bestMove;
+            completedScore = bestScore;
+            completedDepth = depth;
 
             // Store this iteration's PV
             storePV(depth, pv);
@@ -944,10 +846,7 @@ Move Engine::iterativeDeepeningSearch(Board &board, int maxDepth, uint64_t hashK
         if (depth >= 2)
         {
             // Check if best move changed
-            if (bestMove.from.row != previousBestMove.from.row ||
-                bestMove.from.col != previousBestMove.from.col ||
-                bestMove.to.row != previousBestMove.to.row ||
-                bestMove.to.col != previousBestMove.to.col)
+            if (bestMove != previousBestMove)
             {
                 bestMoveChanges++;
             }
@@ -975,17 +874,33 @@ Move Engine::iterativeDeepeningSearch(Board &board, int maxDepth, uint64_t hashK
         // Nodes for this iteration
         long nodesThisIteration = nodesSearched - nodesPrevious;
 
-        std::cout << "Depth: " << depth
-                  << ", Score: " << score
-                  << ", Nodes: " << nodesSearched
-                  << ", Time: " << duration.count() << "ms";
-
-        if (duration.count() > 0)
+        // Helper threads and quiet engines search silently; with a listener
+        // installed it does the reporting
+        if (helperIndex == 0 && searchListener)
         {
-            std::cout << ", NPS: " << static_cast<long>(nodesSearched * 1000.0 / duration.count());
+            reportProgress(depth, score, true);
         }
+        else if (helperIndex == 0 && !quiet)
+        {
+            std::cout << "Depth: " << depth
+                      << ", Score: " << score
+                      << ", Nodes: " << nodesSearched
+                      << ", Time: " << duration.count() << "ms";
 
-        std::cout << ", PV: " << getPVString() << std::endl;
+            if (duration.count() > 0)
+            {
+                std::cout << ", NPS: " << static_cast<long>(nodesSearched * 1000.0 / duration.count());
+            }
+
+            std::cout << ", Pawn hash: " << static_cast<int>(getPawnHashHitRate()) << "%"
+                      << ", PV: " << getPVString() << std::endl;
+        }
+
+        // go mate N: a mate within N moves (2N - 1 plies) has been found
+        if (mateLimit > 0 && std::abs(bestScore) >= 100000 - (2 * mateLimit - 1))
+        {
+            break;
+        }
 
         if (timeManaged && timeAllocated > 0)
         {
@@ -1052,8 +967,7 @@ int Engine::getDepthAdjustment(const Move &move, const Board &board, bool isPVMo
     }
 
     // Losing captures shouldn't get full depth
-    auto capturedPiece = board.getPieceAt(move.to);
-    if (capturedPiece && seeCapture(board, move) < 0)
+    if (move.isCapture() && !seeGE(board, move, 0))
     {
         return -1;
     }
@@ -1087,118 +1001,208 @@ int Engine::getDepthAdjustment(const Move &move, const Board &board, bool isPVMo
     return -reduction;
 }
 
-// Static Exchange Evaluation (SEE)
+// Static Exchange Evaluation (SEE): the material balance of the exchange a
+// move starts on its destination square, both sides always recapturing with
+// their least valuable attacker and either side free to stop. Works on a swap
+// list over attack bitboards; a slider behind a piece that has captured joins
+// in (x-ray) because attackers are recomputed against the emptied squares.
+// Pins are ignored.
 int Engine::seeCapture(const Board &board, const Move &move) const
 {
-    auto movingPiece = board.getPieceAt(move.from);
-    if (!movingPiece)
+    if (move.isCastle())
     {
-        return 0; // Invalid move - no piece at source
+        return 0;
     }
 
-    auto capturedPiece = board.getPieceAt(move.to);
-    if (!capturedPiece)
+    int from = move.fromSquare();
+    int to = move.toSquare();
+    PieceType onSquare = board.getPieceTypeAt(from);
+    if (onSquare == PieceType::NONE)
     {
-        // Check for en passant
-        if (movingPiece->getType() == PieceType::PAWN &&
-            move.to == board.getEnPassantTarget())
-        {
-            return PAWN_VALUE; // En passant captures a pawn
-        }
-        return 0; // Not a capture
+        return 0; // Move does not match this board
     }
+    Color side = board.getPieceColorAt(from);
 
-    // Use SEE cache for performance
-    uint64_t moveKey = ((uint64_t)move.from.row << 24) | 
-                       ((uint64_t)move.from.col << 16) | 
-                       ((uint64_t)move.to.row << 8) | 
-                       ((uint64_t)move.to.col);
-    
-    auto it = seeCache.find(moveKey);
-    if (it != seeCache.end()) {
-        return it->second;
+    Bitboard occupied = board.getOccupied() ^ Bitboards::squareBB(from);
+    int gain[32];
+    if (move.isEnPassant())
+    {
+        occupied ^= Bitboards::squareBB(side == Color::WHITE ? to - 8 : to + 8);
+        gain[0] = PAWN_VALUE;
+    }
+    else
+    {
+        gain[0] = getPieceValue(board.getPieceTypeAt(to));
+    }
+    if (move.isPromotion())
+    {
+        gain[0] += getPieceValue(move.promotion()) - PAWN_VALUE;
+        onSquare = move.promotion();
     }
 
-    // Create a temporary board with the capture made
-    Board tempBoard = board;
-    tempBoard.setPieceAt(move.from, nullptr);
-    tempBoard.setPieceAt(move.to, movingPiece);
+    Bitboard diagonalSliders = board.getPieces(Color::WHITE, PieceType::BISHOP) | board.getPieces(Color::BLACK, PieceType::BISHOP) |
+                               board.getPieces(Color::WHITE, PieceType::QUEEN) | board.getPieces(Color::BLACK, PieceType::QUEEN);
+    Bitboard straightSliders = board.getPieces(Color::WHITE, PieceType::ROOK) | board.getPieces(Color::BLACK, PieceType::ROOK) |
+                               board.getPieces(Color::WHITE, PieceType::QUEEN) | board.getPieces(Color::BLACK, PieceType::QUEEN);
+    Bitboard attackers = board.attackersTo(to, occupied) & occupied;
 
-    int captureValue = getPieceValue(capturedPiece->getType());
-    int attackerValue = getPieceValue(movingPiece->getType());
+    int count = 1;
+    while (count < 32)
+    {
+        side = (side == Color::WHITE) ? Color::BLACK : Color::WHITE;
+        Bitboard ours = attackers & board.getPieces(side);
+        if (!ours)
+        {
+            break;
+        }
 
-    // Calculate what happens if the opponent recaptures
-    int opponentResponse = see(tempBoard, move.to, movingPiece->getColor(), attackerValue);
+        // Least valuable attacker (piece types are ordered by value)
+        PieceType attackerType = PieceType::PAWN;
+        Bitboard candidates = 0;
+        for (int t = static_cast<int>(PieceType::PAWN); t <= static_cast<int>(PieceType::KING); t++)
+        {
+            attackerType = static_cast<PieceType>(t);
+            candidates = ours & board.getPieces(side, attackerType);
+            if (candidates)
+            {
+                break;
+            }
+        }
 
-    int result = captureValue - opponentResponse;
-    
-    // Cache the result
-    seeCache[moveKey] = result;
-    
-    return result;
+        // The king cannot capture onto a square the other side still attacks
+        if (attackerType == PieceType::KING && (attackers & ~board.getPieces(side)))
+        {
+            break;
+        }
+
+        // What this side stands at if it captures and nothing comes back
+        gain[count] = getPieceValue(onSquare) - gain[count - 1];
+        count++;
+
+        onSquare = attackerType;
+        occupied ^= Bitboards::squareBB(Bitboards::lsb(candidates));
+        if (attackerType == PieceType::PAWN || attackerType == PieceType::BISHOP || attackerType == PieceType::QUEEN)
+        {
+            attackers |= Bitboards::bishopAttacks(to, occupied) & diagonalSliders;
+        }
+        if (attackerType == PieceType::ROOK || attackerType == PieceType::QUEEN)
+        {
+            attackers |= Bitboards::rookAttacks(to, occupied) & straightSliders;
+        }
+        attackers &= occupied;
+    }
+
+    // Walk back: each side only continues the exchange when that does not lose
+    for (int d = count - 1; d > 0; d--)
+    {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    }
+    return gain[0];
 }
 
-// Static Exchange Evaluation - simulates a sequence of captures on a square
-int Engine::see(const Board &board, const Position &square, Color side, int captureValue) const
+// Threshold SEE: whether seeCapture(board, move) >= threshold. Cheaper, as it
+// stops as soon as the answer is known instead of resolving the exchange.
+bool Engine::seeGE(const Board &board, const Move &move, int threshold) const
 {
-    // Find all attackers of the given square, sorted by piece value (least valuable first)
-    std::vector<std::pair<int, Position>> attackers;
-
-    for (int row = 0; row < 8; row++)
+    if (move.isCastle())
     {
-        for (int col = 0; col < 8; col++)
-        {
-            Position pos(row, col);
-            auto piece = board.getPieceAt(pos);
+        return threshold <= 0;
+    }
 
-            if (piece && piece->getColor() != side)
-            {
-                // Check if this piece can attack the target square
-                auto moves = piece->getLegalMoves(board);
+    int from = move.fromSquare();
+    int to = move.toSquare();
+    PieceType moving = board.getPieceTypeAt(from);
+    if (moving == PieceType::NONE)
+    {
+        return threshold <= 0;
+    }
+    Color side = board.getPieceColorAt(from);
 
-                for (const auto &move : moves)
-                {
-                    if (move.to == square)
-                    {
-                        int pieceValue = getPieceValue(piece->getType());
-                        attackers.emplace_back(pieceValue, pos);
-                        break; // Only need to know it can attack, not how many ways
-                    }
-                }
-            }
-        }
+    Bitboard occupied = board.getOccupied() ^ Bitboards::squareBB(from);
+    int captured;
+    if (move.isEnPassant())
+    {
+        occupied ^= Bitboards::squareBB(side == Color::WHITE ? to - 8 : to + 8);
+        captured = PAWN_VALUE;
+    }
+    else
+    {
+        captured = getPieceValue(board.getPieceTypeAt(to));
+    }
+    if (move.isPromotion())
+    {
+        captured += getPieceValue(move.promotion()) - PAWN_VALUE;
+        moving = move.promotion();
     }
 
-    // If no attackers, the previous capture stands
-    if (attackers.empty())
+    // swap is how far the side that just captured is above the threshold if the
+    // exchange stops now, seen from the side to capture next (so it is negated
+    // at every step)
+    int swap = captured - threshold;
+    if (swap < 0)
     {
-        return 0;
+        return false; // Even keeping the captured piece is not enough
+    }
+    swap = getPieceValue(moving) - swap;
+    if (swap <= 0)
+    {
+        return true; // Even losing the moved piece is enough
     }
 
-    // Sort attackers by piece value (least valuable first for optimal play)
-    std::sort(attackers.begin(), attackers.end(),
-          [](const std::pair<int, Position> &a, const std::pair<int, Position> &b)
-          {
-              return a.first < b.first;
-          });
+    Bitboard diagonalSliders = board.getPieces(Color::WHITE, PieceType::BISHOP) | board.getPieces(Color::BLACK, PieceType::BISHOP) |
+                               board.getPieces(Color::WHITE, PieceType::QUEEN) | board.getPieces(Color::BLACK, PieceType::QUEEN);
+    Bitboard straightSliders = board.getPieces(Color::WHITE, PieceType::ROOK) | board.getPieces(Color::BLACK, PieceType::ROOK) |
+                               board.getPieces(Color::WHITE, PieceType::QUEEN) | board.getPieces(Color::BLACK, PieceType::QUEEN);
+    Bitboard attackers = board.attackersTo(to, occupied) & occupied;
 
-    // Take the least valuable attacker
-    int attackerValue = attackers[0].first;
+    // result flips with every capture: 1 while the mover is ahead of the threshold
+    int result = 1;
+    while (true)
+    {
+        side = (side == Color::WHITE) ? Color::BLACK : Color::WHITE;
+        attackers &= occupied;
+        Bitboard ours = attackers & board.getPieces(side);
+        if (!ours)
+        {
+            break;
+        }
+        result ^= 1;
 
-    // Create a temporary board to simulate the capture
-    Board tempBoard = board;
+        PieceType attackerType = PieceType::PAWN;
+        Bitboard candidates = 0;
+        for (int t = static_cast<int>(PieceType::PAWN); t <= static_cast<int>(PieceType::KING); t++)
+        {
+            attackerType = static_cast<PieceType>(t);
+            candidates = ours & board.getPieces(side, attackerType);
+            if (candidates)
+            {
+                break;
+            }
+        }
 
-    // Remove the attacking piece and place it on the target square
-    tempBoard.setPieceAt(attackers[0].second, nullptr);
-    auto attackingPiece = board.getPieceAt(attackers[0].second);
-    tempBoard.setPieceAt(square, attackingPiece);
+        if (attackerType == PieceType::KING)
+        {
+            // Capturing with the king only works if nothing can take it back
+            return (attackers & ~board.getPieces(side)) ? (result ^ 1) != 0 : result != 0;
+        }
 
-    // Recursively calculate the score if the opponent recaptures
-    // Note: we flip the side and negate the result
-    int opponentResponse = see(tempBoard, square, (side == Color::WHITE) ? Color::BLACK : Color::WHITE, attackerValue);
+        swap = getPieceValue(attackerType) - swap;
+        if (swap < result)
+        {
+            break; // This side is done even if its capturer is lost
+        }
 
-    // The score is: what we capture minus what the opponent gets back
-    return std::max(0, captureValue - opponentResponse);
+        occupied ^= Bitboards::squareBB(Bitboards::lsb(candidates));
+        if (attackerType == PieceType::PAWN || attackerType == PieceType::BISHOP || attackerType == PieceType::QUEEN)
+        {
+            attackers |= Bitboards::bishopAttacks(to, occupied) & diagonalSliders;
+        }
+        if (attackerType == PieceType::ROOK || attackerType == PieceType::QUEEN)
+        {
+            attackers |= Bitboards::rookAttacks(to, occupied) & straightSliders;
+        }
+    }
+    return result != 0;
 }
 
 // Get the approximate value of a piece for SEE
@@ -1250,15 +1254,12 @@ void Engine::storeEnhancedKillerMove(const Move &move, int ply)
     }
     
     // Additional safety check for move validity
-    if (!move.from.isValid() || !move.to.isValid()) {
+    if (move.isNull()) {
         return;
     }
 
     // Don't store if it's already the first killer move
-    if (killerMoves[ply][0].from.row == move.from.row &&
-        killerMoves[ply][0].from.col == move.from.col &&
-        killerMoves[ply][0].to.row == move.to.row &&
-        killerMoves[ply][0].to.col == move.to.col)
+    if (killerMoves[ply][0] == move)
     {
         return;
     }
@@ -1285,16 +1286,13 @@ bool Engine::isKillerMove(const Move &move, int ply) const
     }
     
     // Additional safety check for move validity
-    if (!move.from.isValid() || !move.to.isValid()) {
+    if (move.isNull()) {
         return false;
     }
 
     // Check all 4 killer move slots
     for (int i = 0; i < 4; i++) {
-        if (killerMoves[ply][i].from.row == move.from.row &&
-            killerMoves[ply][i].from.col == move.from.col &&
-            killerMoves[ply][i].to.row == move.to.row &&
-            killerMoves[ply][i].to.col == move.to.col) {
+        if (killerMoves[ply][i] == move) {
             return true;
         }
     }
@@ -1304,49 +1302,49 @@ bool Engine::isKillerMove(const Move &move, int ply) const
 // Store counter move
 void Engine::storeCounterMove(const Move &lastMove, const Move &counterMove)
 {
-    if (!lastMove.from.isValid() || !lastMove.to.isValid())
+    if (lastMove.isNull())
         return;
 
     // Get the current board state AFTER the move was made
-    auto pieceAtDestination = game.getBoard().getPieceAt(lastMove.to);
+    auto pieceAtDestination = game.getBoard().getPieceAt(lastMove.to());
     if (!pieceAtDestination)
         return;
 
     // The counter move should be indexed by the OPPONENT's move
     int opponentPieceType = static_cast<int>(pieceAtDestination->getType());
     int opponentColor = (pieceAtDestination->getColor() == Color::WHITE) ? 0 : 1;
-    int fromIdx = lastMove.from.row * 8 + lastMove.from.col;
-    int toIdx = lastMove.to.row * 8 + lastMove.to.col;
+    int fromIdx = lastMove.fromSquare();
+    int toIdx = lastMove.toSquare();
 
     // Store the counter move
-    counterMovesPtr[opponentPieceType * 2 * 64 * 64 + opponentColor * 64 * 64 + fromIdx * 64 + toIdx] = counterMove;
+    counterMoves[opponentPieceType * 2 * 64 * 64 + opponentColor * 64 * 64 + fromIdx * 64 + toIdx] = counterMove;
 }
 
 // Get counter move
 Move Engine::getCounterMove(const Move &lastMove) const
 {
-    if (!lastMove.from.isValid() || !lastMove.to.isValid())
-        return Move(Position(0, 0), Position(0, 0));
+    if (lastMove.isNull())
+        return Move();
 
     // Get the piece that made the last move (opponent's piece)
-    auto piece = game.getBoard().getPieceAt(lastMove.to);
+    auto piece = game.getBoard().getPieceAt(lastMove.to());
     if (!piece)
-        return Move(Position(0, 0), Position(0, 0));
+        return Move();
 
     // Use the same indexing as storage
     int pieceType = static_cast<int>(piece->getType());
     int color = (piece->getColor() == Color::WHITE) ? 0 : 1;
-    int fromIdx = lastMove.from.row * 8 + lastMove.from.col;
-    int toIdx = lastMove.to.row * 8 + lastMove.to.col;
+    int fromIdx = lastMove.fromSquare();
+    int toIdx = lastMove.toSquare();
 
-    return counterMovesPtr[pieceType * 2 * 64 * 64 + color * 64 * 64 + fromIdx * 64 + toIdx];
+    return counterMoves[pieceType * 2 * 64 * 64 + color * 64 * 64 + fromIdx * 64 + toIdx];
 }
 
 // Enhanced Move Ordering Methods
 void Engine::updateButterflyHistory(const Move &move, int depth, Color color)
 {
-    int fromIdx = move.from.row * 8 + move.from.col;
-    int toIdx = move.to.row * 8 + move.to.col;
+    int fromIdx = move.fromSquare();
+    int toIdx = move.toSquare();
     
     // Calculate bonus based on depth - but cap it to prevent overflow
     int bonus = std::min(depth * depth, 512);
@@ -1397,38 +1395,38 @@ void Engine::updateButterflyHistory(const Move &move, int depth, Color color)
 
 void Engine::storeCountermoveHistory(const Move &lastMove, const Move &counterMove)
 {
-    if (!lastMove.to.isValid() || !counterMove.from.isValid())
+    if (!lastMove.to().isValid() || !counterMove.from().isValid())
         return;
     
-    auto lastPiece = game.getBoard().getPieceAt(lastMove.to);
+    auto lastPiece = game.getBoard().getPieceAt(lastMove.to());
     if (!lastPiece)
         return;
     
     int pieceType = static_cast<int>(lastPiece->getType());
-    int toSquare = lastMove.to.row * 8 + lastMove.to.col;
+    int toSquare = lastMove.toSquare();
     
     countermoveHistory[pieceType][toSquare] = counterMove;
 }
 
 Move Engine::getCountermoveHistory(const Move &lastMove) const
 {
-    if (!lastMove.to.isValid())
-        return Move(Position(0, 0), Position(0, 0));
+    if (!lastMove.to().isValid())
+        return Move();
     
-    auto lastPiece = game.getBoard().getPieceAt(lastMove.to);
+    auto lastPiece = game.getBoard().getPieceAt(lastMove.to());
     if (!lastPiece)
-        return Move(Position(0, 0), Position(0, 0));
+        return Move();
     
     int pieceType = static_cast<int>(lastPiece->getType());
-    int toSquare = lastMove.to.row * 8 + lastMove.to.col;
+    int toSquare = lastMove.toSquare();
     
     return countermoveHistory[pieceType][toSquare];
 }
 
 int Engine::getButterflyScore(const Move &move) const
 {
-    int fromIdx = move.from.row * 8 + move.from.col;
-    int toIdx = move.to.row * 8 + move.to.col;
+    int fromIdx = move.fromSquare();
+    int toIdx = move.toSquare();
     return butterflyHistory[fromIdx][toIdx];
 }
 
@@ -1437,15 +1435,13 @@ int Engine::getEnhancedMoveScore(const Move& move, const Board& board, const Mov
                                 int ply, Color sideToMove, const Move& lastMove) const
 {
     // Check for valid moving piece first
-    auto movingPiece = board.getPieceAt(move.from);
-    if (!movingPiece) {
+    PieceType movingType = board.getPieceTypeAt(move.fromSquare());
+    if (movingType == PieceType::NONE) {
         return -999999; // Invalid move - heavily penalize
     }
 
     // 1. Transposition table move (highest priority)
-    if (ttMove.from.isValid() && ttMove.to.isValid() &&
-        ttMove.from.row == move.from.row && ttMove.from.col == move.from.col &&
-        ttMove.to.row == move.to.row && ttMove.to.col == move.to.col)
+    if (!ttMove.isNull() && ttMove == move)
     {
         return 10000000; // Highest priority
     }
@@ -1460,14 +1456,14 @@ int Engine::getEnhancedMoveScore(const Move& move, const Board& board, const Mov
     }
 
     // 3. Winning captures (positive SEE) - ordered by victim value then SEE score
-    auto capturedPiece = board.getPieceAt(move.to);
-    if (capturedPiece) {
+    if (move.isCapture()) {
         int seeScore = seeCapture(board, move);
+        PieceType victimType = move.isEnPassant() ? PieceType::PAWN : board.getPieceTypeAt(move.toSquare());
         
         if (seeScore > 0) {
             // Good captures: prioritize by victim value, then by SEE score
-            int victimValue = getPieceValue(capturedPiece->getType());
-            int attackerValue = getPieceValue(movingPiece->getType());
+            int victimValue = getPieceValue(victimType);
+            int attackerValue = getPieceValue(movingType);
             
             // MVV-LVA: Most Valuable Victim - Least Valuable Attacker
             int mvvLvaScore = (victimValue * 100) - (attackerValue / 10);
@@ -1476,7 +1472,7 @@ int Engine::getEnhancedMoveScore(const Move& move, const Board& board, const Mov
         }
         // Even captures: still prioritize over non-captures but below good ones
         else if (seeScore == 0) {
-            int victimValue = getPieceValue(capturedPiece->getType());
+            int victimValue = getPieceValue(victimType);
             return 7000000 + victimValue;
         }
         // Bad captures: lowest priority among captures
@@ -1486,18 +1482,14 @@ int Engine::getEnhancedMoveScore(const Move& move, const Board& board, const Mov
     }
 
     // 4. Enhanced Counter moves
-    if (lastMove.from.isValid() && lastMove.to.isValid())
+    if (!lastMove.isNull())
     {
         // Try both counter move systems
         Move counter = getCounterMove(lastMove);
         Move counterHist = getCountermoveHistory(lastMove);
         
-        if ((counter.from.isValid() && counter.to.isValid() &&
-            counter.from.row == move.from.row && counter.from.col == move.from.col &&
-            counter.to.row == move.to.row && counter.to.col == move.to.col) ||
-            (counterHist.from.isValid() && counterHist.to.isValid() &&
-            counterHist.from.row == move.from.row && counterHist.from.col == move.from.col &&
-            counterHist.to.row == move.to.row && counterHist.to.col == move.to.col))
+        if ((!counter.isNull() && counter == move) ||
+            (!counterHist.isNull() && counterHist == move))
         {
             return 5000000;
         }
@@ -1508,46 +1500,79 @@ int Engine::getEnhancedMoveScore(const Move& move, const Board& board, const Mov
     {
         // Give higher scores to more recent killer moves
         for (int i = 0; i < 4; i++) {
-            if (ply < MAX_PLY && 
-                killerMoves[ply][i].from.row == move.from.row &&
-                killerMoves[ply][i].from.col == move.from.col &&
-                killerMoves[ply][i].to.row == move.to.row &&
-                killerMoves[ply][i].to.col == move.to.col)
+            if (ply < MAX_PLY && killerMoves[ply][i] == move)
             {
                 return 4000000 + (4 - i) * 25; // More recent = higher score
             }
         }
     }
 
-    // 6. Enhanced History scoring (combine traditional + butterfly)
+    // 6. History and positional scoring for the remaining (quiet) moves
+    return getQuietMoveScore(move, board, sideToMove);
+}
+
+int Engine::getQuietMoveScore(const Move& move, const Board& board, Color sideToMove) const
+{
+    PieceType movingType = board.getPieceTypeAt(move.fromSquare());
+
+    // Enhanced History scoring (combine traditional + butterfly)
     int traditionHistoryScore = getHistoryScore(move, sideToMove);
     int butterflyScore = getButterflyScore(move);
     int combinedHistoryScore = traditionHistoryScore + (butterflyScore / 2);
     
-    // 7. Basic positional scoring for remaining moves
+    // Basic positional scoring
     int positionalScore = 0;
     
     // Bonus for moves toward the center
-    int centerDistance = abs(move.to.row - 3.5) + abs(move.to.col - 3.5);
+    int centerDistance = abs(move.to().row - 3.5) + abs(move.to().col - 3.5);
     positionalScore += (7 - centerDistance) * 10;
     
     // Bonus for advancing pawns
-    if (movingPiece->getType() == PieceType::PAWN) {
+    if (movingType == PieceType::PAWN) {
         if (sideToMove == Color::WHITE) {
-            positionalScore += move.to.row * 20;
+            positionalScore += move.to().row * 20;
         } else {
-            positionalScore += (7 - move.to.row) * 20;
+            positionalScore += (7 - move.to().row) * 20;
         }
     }
     
     return combinedHistoryScore + positionalScore;
 }
 
+int Engine::getCaptureScore(const Move& move, const Board& board) const
+{
+    int score = 0;
+    if (move.isCapture())
+    {
+        PieceType attacker = board.getPieceTypeAt(move.fromSquare());
+        PieceType victim = move.isEnPassant() ? PieceType::PAWN : board.getPieceTypeAt(move.toSquare());
+        score = getMVVLVAScore(attacker, victim);
+    }
+    // Promotions go by what the pawn becomes, queening first
+    if (move.isPromotion())
+    {
+        score += getPieceValue(move.promotion());
+    }
+    return score;
+}
+
+Move Engine::getPVMove(int ply) const
+{
+    for (int d = std::min(maxDepth, MAX_PLY - 1); d >= 1; d--)
+    {
+        if (ply < static_cast<int>(pvTable[d].size()))
+        {
+            return pvTable[d][ply];
+        }
+    }
+    return Move();
+}
+
 void Engine::updateHistoryScore(const Move &move, int depth, Color color)
 {
     int colorIdx = (color == Color::WHITE) ? 0 : 1;
-    int fromIdx = move.from.row * 8 + move.from.col;
-    int toIdx = move.to.row * 8 + move.to.col;
+    int fromIdx = move.fromSquare();
+    int toIdx = move.toSquare();
 
     // Robust history table overflow prevention
     
@@ -1609,28 +1634,25 @@ void Engine::updateHistoryScore(const Move &move, int depth, Color color)
 int Engine::getHistoryScore(const Move &move, Color color) const
 {
     int colorIdx = (color == Color::WHITE) ? 0 : 1;
-    int fromIdx = move.from.row * 8 + move.from.col;
-    int toIdx = move.to.row * 8 + move.to.col;
+    int fromIdx = move.fromSquare();
+    int toIdx = move.toSquare();
 
     return historyTable[colorIdx][fromIdx][toIdx];
 }
 
 // Check if a move is part of the principal variation (deprecated version for compatibility)
-bool Engine::isPVMove(const Move &move, const std::vector<Move> &pv, int ply) const
+bool Engine::isPVMove(const Move &move, const PVLine &pv, int ply) const
 {
     if (pv.size() <= static_cast<size_t>(ply))
         return false;
 
     const Move &pvMove = pv[ply];
-    return (pvMove.from.row == move.from.row &&
-            pvMove.from.col == move.from.col &&
-            pvMove.to.row == move.to.row &&
-            pvMove.to.col == move.to.col);
+    return (pvMove == move);
 }
 
 // Legacy getMoveScore for compatibility
 int Engine::getMoveScore(const Move &move, const Board &board, const Move &ttMove,
-                         const std::vector<Move> &pv, int ply, Color sideToMove,
+                         const PVLine &pv, int ply, Color sideToMove,
                          const Move &lastMove) const
 {
     // Redirect to enhanced version
@@ -1744,187 +1766,198 @@ int Engine::quiescenceSearch(Board &board, int alpha, int beta, uint64_t hashKey
     // Track nodes searched
     nodesSearched++;
 
+    if (ply > selDepth)
+    {
+        selDepth = ply;
+    }
+
+    // Node limit (UCI go nodes)
+    if (nodeLimit > 0 && nodesSearched >= nodeLimit)
+    {
+        searchShouldStop.store(true);
+        return evaluatePosition(board);
+    }
+
     // Check for search termination every ~1000 nodes
     if ((nodesSearched % 1000) == 0 && shouldStopSearch()) {
         return evaluatePosition(board);
     }
 
-    // Maximum recursion depth check for quiescence
-    if (ply >= MAX_QSEARCH_DEPTH)
+    // Captures run out on their own; this only guards the per-ply tables and the undo stack
+    if (ply >= MAX_PLY - 1)
         return evaluatePosition(board);
 
-    // Stand-pat score (evaluate the current position without making any moves)
-    int standPat = evaluatePosition(board);
-
-    // Beta cutoff
-    if (standPat >= beta)
-        return beta;
-
-    // Update alpha if stand-pat score is better
-    if (standPat > alpha)
-        alpha = standPat;
-
-    std::vector<Move> qMoves;
-    bool inCheck = board.isInCheck();
-
-    if (inCheck) {
-        // Generate only check evasions - much more efficient than all legal moves
-        generateCheckEvasions(board, qMoves);
-    } else {
-        // Generate only captures and promotions
-        generateCaptureMoves(board, qMoves);
-        
-        // Add queen promotions even if not captures (they're very strong)
-        generatePromotions(board, qMoves);
+    // Only depth-0 entries, which quiescence search alone writes, give a score:
+    // pvSearch entries are not scored the way this negamax search scores a node.
+    // Any entry's move is searched first.
+    int score;
+    Move ttMove;
+    if (transpositionTable->probe(hashKey, 0, alpha, beta, score, ttMove, true))
+    {
+        return score;
     }
 
-    if (qMoves.empty())
-        return standPat;
+    int originalAlpha = alpha;
+    bool inCheck = board.isInCheck();
 
-    // Score and sort the moves
-    std::vector<std::pair<int, Move>> scoredMoves;
-    for (const auto &move : qMoves)
+    // In check there is no standing pat: every evasion is searched
+    int standPat = 0;
+    if (!inCheck)
     {
-        // Score the move
-        int moveScore = 0;
-
-        auto movingPiece = board.getPieceAt(move.from);
-        auto capturedPiece = board.getPieceAt(move.to);
-
-        bool isCapture = capturedPiece != nullptr ||
-                         (movingPiece && movingPiece->getType() == PieceType::PAWN &&
-                          move.to == board.getEnPassantTarget());
+        // Stand-pat score (evaluate the current position without making any moves)
+        standPat = evaluatePosition(board);
 
-        // Delta pruning - skip captures that can't improve alpha
-        if (isCapture && !inCheck && ply > 0)
+        // Beta cutoff
+        if (standPat >= beta)
         {
-            // Get the maximum possible material gain from this capture
-            int captureValue = 0;
-            if (capturedPiece)
-            {
-                captureValue = getPieceValue(capturedPiece->getType());
-            }
-            else if (move.to == board.getEnPassantTarget())
-            {
-                captureValue = PAWN_VALUE;
-            }
-
-            // Add potential promotion bonus
-            int promotionBonus = 0;
-            if (movingPiece && movingPiece->getType() == PieceType::PAWN &&
-                (move.to.row == 0 || move.to.row == 7))
+            if (!searchShouldStop.load(std::memory_order_relaxed))
             {
-                promotionBonus = QUEEN_VALUE - PAWN_VALUE;
+                transpositionTable->store(hashKey, 0, standPat, NodeType::BETA, Move());
             }
-
-            // Delta margin - a buffer to account for positional gains
-            const int DELTA_MARGIN = 200;
-
-            // Skip if even the maximum possible gain can't improve alpha
-            if (standPat + captureValue + promotionBonus + DELTA_MARGIN <= alpha)
-            {
-                continue; // Skip this capture - it can't improve alpha
-            }
-
-            // Additional futility pruning for bad captures
-            if (capturedPiece && seeCapture(board, move) < -50)
-            {
-                continue; // Skip obviously bad captures
-            }
-        }
-
-        if (capturedPiece)
-        {
-            // MVV-LVA scoring for captures
-            if (movingPiece) {
-                moveScore = 10000000 + getMVVLVAScore(movingPiece->getType(), capturedPiece->getType());
-
-                // Static Exchange Evaluation (SEE)
-                int seeScore = seeCapture(board, move);
-                if (seeScore < 0)
-                {
-                    // Skip bad captures at deeper ply depths
-                    if (ply > 2 && !inCheck)
-                        continue;
-
-                    // Penalize bad captures, but still consider them
-                    moveScore += seeScore;
-                }
-            }
-        }
-        else if (movingPiece && movingPiece->getType() == PieceType::PAWN &&
-                 move.to == board.getEnPassantTarget())
-        {
-            // En passant capture
-            moveScore = 10000000 + getMVVLVAScore(movingPiece->getType(), PieceType::PAWN);
-        }
-        else
-        {
-            // Non-capture move (likely a check)
-            // Score lower than captures but still consider
-            moveScore = 1000000;
+            return beta;
         }
 
-        scoredMoves.push_back(std::make_pair(moveScore, move));
+        // Update alpha if stand-pat score is better
+        if (standPat > alpha)
+            alpha = standPat;
     }
 
-    // Sort moves by score (descending)
-    std::sort(scoredMoves.begin(), scoredMoves.end(),
-              [](const std::pair<int, Move> &a, const std::pair<int, Move> &b)
-              {
-                  return a.first > b.first;
-              });
+    // Winning and even captures and queen promotions, best first; losing
+    // captures are pruned by SEE. In check, all evasions.
+    MovePicker picker(*this, board, ttMove);
+    Move bestMove;
+    bool anyLegal = false;
 
-    // Make each move and recursively search
-    for (const auto &scoredMove : scoredMoves)
+    Move move;
+    while (!(move = picker.next()).isNull())
     {
-        const Move &move = scoredMove.second;
+        // Delta pruning - skip captures that can't improve alpha even with a margin
+        if (!inCheck && !move.isPromotion())
+        {
+            PieceType capturedType = move.isEnPassant() ? PieceType::PAWN : board.getPieceTypeAt(move.toSquare());
+            const int DELTA_MARGIN = 200;
+            if (standPat + getPieceValue(capturedType) + DELTA_MARGIN <= alpha)
+            {
+                continue;
+            }
+        }
 
         // Save board state for unmaking move
-        BoardState previousState;
+        BoardState &previousState = undoStack[ply];
 
-        // Calculate new hash key BEFORE making the move
-        uint64_t newHashKey = zobristHasher.updateHashKey(hashKey, move, board);
+        // Fetch the child's TT cluster and pawn hash entry while the move is made and checked
+        prefetchChild(board, move);
 
         // Make the move
-        if (!board.makeMove(move, previousState))
+        if (!board.makePseudoLegalMove(move, previousState))
             continue;
+        anyLegal = true;
+
+        // The board keeps its hash key up to date
+        uint64_t newHashKey = board.getHashKey();
 
         // Recursively search
-        int score = -quiescenceSearch(board, -beta, -alpha, newHashKey, ply + 1);
+        score = -quiescenceSearch(board, -beta, -alpha, newHashKey, ply + 1);
 
         // Unmake the move
         board.unmakeMove(move, previousState);
 
         // Beta cutoff
         if (score >= beta)
+        {
+            if (!searchShouldStop.load(std::memory_order_relaxed))
+            {
+                transpositionTable->store(hashKey, 0, score, NodeType::BETA, move);
+            }
             return beta;
+        }
 
         // Update alpha
         if (score > alpha)
+        {
             alpha = score;
+            bestMove = move;
+        }
+    }
+
+    // Checkmated: the picker gave out every evasion
+    if (inCheck && !anyLegal)
+    {
+        return -100000 + ply;
+    }
+
+    if (!searchShouldStop.load(std::memory_order_relaxed))
+    {
+        transpositionTable->store(hashKey, 0, alpha, alpha > originalAlpha ? NodeType::EXACT : NodeType::ALPHA,
+                                  bestMove);
     }
 
     return alpha;
 }
 
 // Principal Variation Search (PVS) with NULL MOVE PRUNING
+void Engine::prefetchChild(const Board& board, const Move& move) const
+{
+    if (!prefetchEnabled)
+    {
+        return;
+    }
+    uint64_t childKey;
+    uint64_t childPawnKey;
+    board.keysAfter(move, childKey, childPawnKey);
+    transpositionTable->prefetch(childKey);
+    // Quiet piece moves keep the pawn entry the evaluation is already using
+    if (childPawnKey != board.getPawnKey())
+    {
+        pawnHashTable->prefetch(childPawnKey);
+    }
+}
+
 int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizingPlayer,
-                     std::vector<Move> &pv, uint64_t hashKey, int ply, Move lastMove)
+                     PVLine &pv, uint64_t hashKey, int ply, Move lastMove)
 {
     // Track nodes searched
     nodesSearched++;
 
+    // Node limit (UCI go nodes)
+    if (nodeLimit > 0 && nodesSearched >= nodeLimit)
+    {
+        searchShouldStop.store(true);
+    }
+
+    // Unwind quickly once a stop has been requested (time, UCI stop, or the main thread finishing)
+    if (ply > 0 && searchShouldStop.load(std::memory_order_relaxed))
+    {
+        return 0;
+    }
+
+    if (ply > selDepth)
+    {
+        selDepth = ply;
+    }
+
+    // Guards the per-ply tables and the undo stack
+    if (ply >= MAX_PLY - 1)
+    {
+        return evaluatePosition(board);
+    }
+
+    // Periodic progress report for long iterations (checked every 4096 nodes)
+    if (helperIndex == 0 && searchListener && (nodesSearched & 4095) == 0 &&
+        std::chrono::high_resolution_clock::now() - lastProgressReport >= std::chrono::seconds(1))
+    {
+        reportProgress(currentIterationDepth, 0, false);
+    }
+
     // Check transposition table for this position
     int originalAlpha = alpha;
-    Move ttMove(Position(0, 0), Position(0, 0));
     int score;
 
     pv.clear();
 
  // 1. PRIORITY: Probe the transposition table (ALWAYS FIRST)
-    Move tempTTMove(Position(0, 0), Position(0, 0));
-    if (ply > 0 && transpositionTable.probe(hashKey, depth, alpha, beta, score, tempTTMove))
+    Move tempTTMove;
+    if (ply > 0 && transpositionTable->probe(hashKey, depth, alpha, beta, score, tempTTMove))
     {
         return score; // Return cached result if available (but don't use TT at root)
     }
@@ -1950,13 +1983,13 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
         // Make null move (switch sides)
         board.switchSideToMove();
         
-        // Calculate new hash key for null move
-        uint64_t nullHashKey = zobristHasher.generateHashKey(board);
+        // switchSideToMove already toggled the side-to-move key
+        uint64_t nullHashKey = board.getHashKey();
         
         // Search with reduced depth and negated window
-        std::vector<Move> nullPV;
+        PVLine nullPV;
         int nullScore = -pvSearch(board, depth - 1 - reduction, -beta, -beta + 1, 
-                                 !maximizingPlayer, nullPV, nullHashKey, ply + 1, Move(Position(0, 0), Position(0, 0)));
+                                 !maximizingPlayer, nullPV, nullHashKey, ply + 1, Move());
         
         // Unmake null move
         board.switchSideToMove();
@@ -1970,7 +2003,7 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             
             // Verification search for high values to avoid zugzwang
             if (depth >= NULL_MOVE_VERIFICATION_DEPTH && nullScore >= beta + 300) {
-                std::vector<Move> verifyPV;
+                PVLine verifyPV;
                 int verifyScore = pvSearch(board, depth - NULL_MOVE_VERIFICATION_DEPTH, 
                                          beta - 1, beta, maximizingPlayer, verifyPV, hashKey, ply, lastMove);
                 if (verifyScore >= beta) {
@@ -1997,7 +2030,7 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             // Try reduced depth search first
             int reducedDepth = depth - 1 - (depth > 2 ? 1 : 0); // Reduce by 1-2 ply
             
-            std::vector<Move> razorPV;
+            PVLine razorPV;
             int razorScore = pvSearch(board, reducedDepth, alpha - 1, alpha, maximizingPlayer, 
                                     razorPV, hashKey, ply, lastMove);
             
@@ -2006,7 +2039,7 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
                 // Verification search for positions that barely fail
                 if (razorScore >= alpha - 100) {
                     // Close call - do verification search at original depth
-                    std::vector<Move> verifyPV;
+                    PVLine verifyPV;
                     int verifyScore = pvSearch(board, depth - 1, alpha - 1, alpha, maximizingPlayer,
                                              verifyPV, hashKey, ply, lastMove);
                    if (verifyScore < alpha) {
@@ -2036,91 +2069,37 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
         extension = 1;
     }
 
-    // If the game is over, return the evaluation
-    if (board.isCheckmate() || board.isStalemate())
-    {
-        return evaluatePosition(board);
-    }
-
-    // Generate all legal moves
-    std::vector<Move> legalMoves = board.generateLegalMoves();
-
-    // If there are no legal moves, either checkmate or stalemate
-    if (legalMoves.empty())
-    {
-        if (board.isInCheck())
-        {
-            // Checkmate (worst possible score, adjusted for distance to mate)
-            return maximizingPlayer ? -100000 + ply : 100000 - ply;
-        }
-        else
-        {
-            // Stalemate
-            return 0;
-        }
-    }
-
-    // 2. Singular Move Extension - if only one legal move, extend
-    if (legalMoves.size() == 1 && depth >= 2)
-    {
-        extension = std::max(extension, 1);
-    }
-
-    // Score moves using enhanced move ordering
-    std::vector<std::pair<int, Move>> scoredMoves;
-    for (const auto &move : legalMoves)
-    {
-       Move validTTMove = (ttMove.from.isValid() && ttMove.to.isValid()) ? ttMove : Move(Position(0, 0), Position(0, 0));
-        int moveScore = getEnhancedMoveScore(move, board, validTTMove, ply, board.getSideToMove(), lastMove);
-
-        // Early pruning of very bad captures
-        if (depth >= 3)
-        {
-            auto capturedPiece = board.getPieceAt(move.to);
-            if (capturedPiece)
-            {
-                int seeScore = seeCapture(board, move);
-                // If SEE indicates a very bad capture, don't even consider this move
-                if (seeScore < -PAWN_VALUE * 2)
-                {
-                    continue;
-                }
-            }
-        }
-
-        scoredMoves.push_back(std::make_pair(moveScore, move));
-    }
-
-    // Sort moves by score (descending)
-    std::sort(scoredMoves.begin(), scoredMoves.end(),
-              [](const std::pair<int, Move> &a, const std::pair<int, Move> &b)
-              {
-                  return a.first > b.first;
-              });
+    NodeType nodeType = NodeType::ALPHA;
+    Move localBestMove;
 
-    // Clear SEE cache periodically
-    if ((nodesSearched % 5000) == 0) {
-        clearSEECache();
-    }
+    // Moves come from the picker in stages, best first. The hash move is the
+    // TT's best move, or at the root the PV move of the previous iteration.
+    Move hashMove = !tempTTMove.isNull() ? tempTTMove : getPVMove(ply);
+    MovePicker picker(*this, board, hashMove, ply, lastMove);
 
-    NodeType nodeType = NodeType::ALPHA;
-    Move localBestMove = legalMoves.empty() ? Move(Position(0, 0), Position(0, 0)) : legalMoves[0];
     bool foundPV = false;
 
     // This will be used to store the principal variation
-    std::vector<Move> childPV;
+    PVLine childPV;
+
+    // The position is the same for every move; evaluate it once for the pruning below
+    const int currentEval = evaluatePosition(board);
 
     if (maximizingPlayer)
     {
         int maxEval = std::numeric_limits<int>::min();
 
-        for (size_t i = 0; i < scoredMoves.size(); i++)
+        Move move;
+        for (size_t i = 0; !(move = picker.next()).isNull(); i++)
         {
-            const Move &move = scoredMoves[i].second;
+            // Don't even consider captures that SEE says lose a lot
+            if (depth >= 3 && move.isCapture() && !seeGE(board, move, -PAWN_VALUE * 2))
+            {
+                continue;
+            }
 
        // NEW: Futility Pruning Section
-            int currentEval = evaluatePosition(board);
-            bool isCapture = board.getPieceAt(move.to) != nullptr;
+            bool isCapture = move.isCapture();
             
           // 4. PRIORITY: FUTILITY PRUNING (Local move skipping)
             if (ENABLE_FUTILITY_PRUNING && shouldAllowMultiplePruning(depth, ply, board.isInCheck())) {
@@ -2161,10 +2140,13 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             bool isKillerMoveCheck = isKillerMove(move, ply);
 
             // Save board state for unmaking move
-            BoardState previousState;
+            BoardState &previousState = undoStack[ply];
+
+            // Fetch the child's table entries while the move is made and checked
+            prefetchChild(board, move);
 
             // Make the move
-            if (!board.makeMove(move, previousState))
+            if (!board.makePseudoLegalMove(move, previousState))
                 continue;
 
             bool isCheckMove = board.isInCheck();
@@ -2173,17 +2155,17 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             int moveExtension = extension;
 
             // Recapture Extension
-            if (lastMove.to.isValid() && move.to == lastMove.to)
+            if (lastMove.to().isValid() && move.to() == lastMove.to())
             {
                 moveExtension = std::max(moveExtension, 1);
             }
 
             // Pawn Push Extension
-            auto piece = board.getPieceAt(move.to); // Use move.to since piece is now there
-            if (piece && piece->getType() == PieceType::PAWN)
+            // The move has been made, so the mover now stands on the destination
+            if (board.getPieceTypeAt(move.toSquare()) == PieceType::PAWN)
             {
                 int destRow = (board.getSideToMove() == Color::BLACK) ? 6 : 1; // 7th rank (flipped because we switched sides)
-                if (move.to.row == destRow)
+                if (move.to().row == destRow)
                 {
                     moveExtension = std::max(moveExtension, 1);
                 }
@@ -2202,8 +2184,8 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             int newDepth = depth - 1 + moveExtension - lmrReduction;
             newDepth = std::max(0, newDepth);
 
-            // Calculate the new hash key after the move
-            uint64_t newHashKey = zobristHasher.updateHashKey(hashKey, move, board);
+            // The board keeps its hash key up to date
+            uint64_t newHashKey = board.getHashKey();
 
             // Recursively evaluate the position
             childPV.clear();
@@ -2265,9 +2247,7 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
                 localBestMove = move;
 
                 // Update principal variation
-                pv.clear();
-                pv.push_back(move);
-                pv.insert(pv.end(), childPV.begin(), childPV.end());
+                pv.update(move, childPV);
             }
 
             // Alpha-beta pruning
@@ -2281,7 +2261,7 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
                     updateHistoryScore(move, depth, Color::WHITE);
                     updateButterflyHistory(move, depth, Color::WHITE);
 
-    if (lastMove.from.isValid() && lastMove.to.isValid())
+    if (!lastMove.isNull())
                     {
                         storeCounterMove(lastMove, move);
                         storeCountermoveHistory(lastMove, move);
@@ -2293,12 +2273,23 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             }
         }
 
+        // No move was searched: there is none (mate or stalemate, which the
+        // evaluation scores), every one was pruned, or the search is stopping
+        if (maxEval == std::numeric_limits<int>::min())
+        {
+            return currentEval;
+        }
+
         // Store result in transposition table
         if (maxEval > originalAlpha && maxEval < beta)
         {
-            nodeType = NodeType::EXACT;
+            nodeType = NodeType::EXACT;
+        }
+        // Scores from a search cut short by a stop request are unreliable; keep them out of the shared TT
+        if (!searchShouldStop.load(std::memory_order_relaxed))
+        {
+            transpositionTable->store(hashKey, depth, maxEval, nodeType, localBestMove);
         }
-        transpositionTable.store(hashKey, depth, maxEval, nodeType, localBestMove);
 
         return maxEval;
     }
@@ -2307,30 +2298,34 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
         // Minimizing player
         int minEval = std::numeric_limits<int>::max();
 
-        for (size_t i = 0; i < scoredMoves.size(); i++)
+        Move move;
+        for (size_t i = 0; !(move = picker.next()).isNull(); i++)
         {
-            const Move &move = scoredMoves[i].second;
+            // Don't even consider captures that SEE says lose a lot
+            if (depth >= 3 && move.isCapture() && !seeGE(board, move, -PAWN_VALUE * 2))
+            {
+                continue;
+            }
 
             // NEW: Futility Pruning Section
-            int currentMoveEval = evaluatePosition(board);
-            bool isCapture = board.getPieceAt(move.to) != nullptr;
+            bool isCapture = move.isCapture();
             
             // 1. Static Futility Pruning (for quiet moves)
             if (!foundPV && depth <= 3 && !isCapture && i >= 3) {
-                if (canUseFutilityPruning(depth, alpha, beta, currentMoveEval, board.isInCheck())) {
+                if (canUseFutilityPruning(depth, alpha, beta, currentEval, board.isInCheck())) {
                     continue;
                 }
             }
             
             // 2. Reverse Futility Pruning (stand-pat)
             if (!foundPV && depth <= 2 && !board.isInCheck()) {
-                if (canUseReverseFutilityPruning(depth, currentMoveEval, beta)) {
-                    return currentMoveEval;
+                if (canUseReverseFutilityPruning(depth, currentEval, beta)) {
+                    return currentEval;
                 }
             }
             
             // 3. Delta Pruning for captures
-            if (isCapture && canUseDeltaPruning(currentMoveEval, alpha, move, board)) {
+            if (isCapture && canUseDeltaPruning(currentEval, alpha, move, board)) {
                 continue;
             }
 
@@ -2349,10 +2344,13 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             bool isKillerMoveCheck = isKillerMove(move, ply);
 
             // Save board state for unmaking move
-            BoardState previousState;
+            BoardState &previousState = undoStack[ply];
+
+            // Fetch the child's table entries while the move is made and checked
+            prefetchChild(board, move);
 
             // Make the move
-            if (!board.makeMove(move, previousState))
+            if (!board.makePseudoLegalMove(move, previousState))
                 continue;
 
             bool isCheckMove = board.isInCheck();
@@ -2361,17 +2359,16 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             int moveExtension = extension;
 
             // Recapture Extension
-            if (lastMove.to.isValid() && move.to == lastMove.to)
+            if (lastMove.to().isValid() && move.to() == lastMove.to())
             {
                 moveExtension = std::max(moveExtension, 1);
             }
 
             // Pawn Push Extension
-            auto piece = board.getPieceAt(move.to);
-            if (piece && piece->getType() == PieceType::PAWN)
+            if (board.getPieceTypeAt(move.toSquare()) == PieceType::PAWN)
             {
                 int destRow = (board.getSideToMove() == Color::BLACK) ? 6 : 1; // 7th rank
-                if (move.to.row == destRow)
+                if (move.to().row == destRow)
                 {
                     moveExtension = std::max(moveExtension, 1);
                 }
@@ -2385,8 +2382,8 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             int newDepth = depth - 1 + moveExtension - lmrReduction;
             newDepth = std::max(0, newDepth);
 
-            // Calculate the new hash key after the move
-            uint64_t newHashKey = zobristHasher.updateHashKey(hashKey, move, board);
+            // The board keeps its hash key up to date
+            uint64_t newHashKey = board.getHashKey();
 
             // Recursively evaluate the position
             childPV.clear();
@@ -2438,9 +2435,7 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
                 localBestMove = move;
 
                 // Update principal variation
-                pv.clear();
-                pv.push_back(move);
-                pv.insert(pv.end(), childPV.begin(), childPV.end());
+                pv.update(move, childPV);
             }
 
             // Alpha-beta pruning
@@ -2454,7 +2449,7 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
                     updateHistoryScore(move, depth, Color::BLACK);
                     updateButterflyHistory(move, depth, Color::BLACK);
 
-        if (lastMove.from.isValid() && lastMove.to.isValid())
+        if (!lastMove.isNull())
                     {
                         storeCounterMove(lastMove, move);
                         storeCountermoveHistory(lastMove, move);
@@ -2466,12 +2461,22 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
             }
         }
 
+        // No move was searched; see above
+        if (minEval == std::numeric_limits<int>::max())
+        {
+            return currentEval;
+        }
+
         // Store result in transposition table
         if (minEval > originalAlpha && minEval < beta)
         {
             nodeType = NodeType::EXACT;
         }
-        transpositionTable.store(hashKey, depth, minEval, nodeType, localBestMove);
+        // Scores from a search cut short by a stop request are unreliable; keep them out of the shared TT
+        if (!searchShouldStop.load(std::memory_order_relaxed))
+        {
+            transpositionTable->store(hashKey, depth, minEval, nodeType, localBestMove);
+        }
 
         return minEval;
     }
@@ -2479,21 +2484,21 @@ int Engine::pvSearch(Board &board, int depth, int alpha, int beta, bool maximizi
 
 // Regular alpha-beta search (kept for reference/fallback)
 int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximizingPlayer,
-                      std::vector<Move> &pv, uint64_t hashKey, int ply, Move lastMove)
+                      PVLine &pv, uint64_t hashKey, int ply, Move lastMove)
 {
     // Track nodes searched
     nodesSearched++;
 
     // Check transposition table for this position
     int originalAlpha = alpha;
-   Move ttMove(Position(0, 0), Position(0, 0));
+   Move ttMove;
     int score;
 
     pv.clear();
 
 // Probe the transposition table
-    Move tempTTMove(Position(0, 0), Position(0, 0));
-    if (ply > 0 && transpositionTable.probe(hashKey, depth, alpha, beta, score, tempTTMove))
+    Move tempTTMove;
+    if (ply > 0 && transpositionTable->probe(hashKey, depth, alpha, beta, score, tempTTMove))
     {
         return score; // Return cached result if available (but don't use TT at root)
     }
@@ -2511,7 +2516,7 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
     }
 
     // Generate all legal moves
-    std::vector<Move> legalMoves = board.generateLegalMoves();
+    MoveList legalMoves = board.generateLegalMoves();
 
     // If there are no legal moves, either checkmate or stalemate
     if (legalMoves.empty())
@@ -2528,62 +2533,66 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
         }
     }
 
-    // Score each move for ordering
-    std::vector<std::pair<int, Move>> scoredMoves;
-    for (const auto &move : legalMoves)
+    NodeType nodeType = NodeType::ALPHA;
+    Move localBestMove = legalMoves[0];
+
+    // Score each move for ordering, in place in the move list
+    MoveList &scoredMoves = legalMoves;
+    size_t scoredCount = 0;
+    for (size_t index = 0; index < legalMoves.size(); index++)
     {
-       Move validTTMove = (ttMove.from.isValid() && ttMove.to.isValid()) ? ttMove : Move(Position(0, 0), Position(0, 0));
+        const Move move = legalMoves[index];
+       Move validTTMove = (!ttMove.isNull()) ? ttMove : Move();
         int moveScore = getEnhancedMoveScore(move, board, validTTMove, ply, board.getSideToMove(), lastMove);
 
         // Early pruning of very bad captures
         if (depth >= 3)
         {
-            auto capturedPiece = board.getPieceAt(move.to);
-            if (capturedPiece)
+            if (move.isCapture())
             {
-                int seeScore = seeCapture(board, move);
                 // If SEE indicates a very bad capture, don't even consider this move
-                if (seeScore < -PAWN_VALUE * 2)
+                if (!seeGE(board, move, -PAWN_VALUE * 2))
                 {
                     continue;
                 }
             }
         }
 
-        scoredMoves.push_back(std::make_pair(moveScore, move));
+        scoredMoves[scoredCount++] = ScoredMove(move, moveScore);
     }
+    scoredMoves.resize(scoredCount);
 
     // Sort moves by score (descending)
     std::sort(scoredMoves.begin(), scoredMoves.end(),
-              [](const std::pair<int, Move> &a, const std::pair<int, Move> &b)
+              [](const ScoredMove &a, const ScoredMove &b)
               {
-                  return a.first > b.first;
+                  return a.score > b.score;
               });
 
-    NodeType nodeType = NodeType::ALPHA;
-    Move localBestMove = legalMoves.empty() ? Move(Position(0, 0), Position(0, 0)) : legalMoves[0];
 
     // This will be used to store the principal variation
-    std::vector<Move> childPV;
+    PVLine childPV;
 
     if (maximizingPlayer)
     {
         int maxEval = std::numeric_limits<int>::min();
 
-        for (const auto &scoredMove : scoredMoves)
+        for (const auto &move : scoredMoves)
         {
-            const Move &move = scoredMove.second;
 
             // Save board state for unmaking move
             BoardState previousState;
 
-            // Calculate new hash key BEFORE making the move
-            uint64_t newHashKey = zobristHasher.updateHashKey(hashKey, move, board);
+            // Fetch the child's table entries while the move is made and checked
+            prefetchChild(board, move);
 
             // Make the move
-            if (!board.makeMove(move, previousState))
+            if (!board.makePseudoLegalMove(move, previousState))
                 continue;
 
+            // The board keeps its hash key up to date
+            uint64_t newHashKey = board.getHashKey();
+
             // Recursively evaluate the position
             childPV.clear();
             int eval = alphaBeta(board, depth - 1, alpha, beta, false, childPV, newHashKey, ply + 1, move);
@@ -2598,9 +2607,7 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
                 localBestMove = move;
 
                 // Update principal variation
-                pv.clear();
-                pv.push_back(move);
-                pv.insert(pv.end(), childPV.begin(), childPV.end());
+                pv.update(move, childPV);
             }
 
             // Alpha-beta pruning
@@ -2608,7 +2615,7 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
             if (beta <= alpha)
             {
                 // Store this move as a killer move if it's not a capture
-                if (board.getPieceAt(move.to) == nullptr)
+                if (!move.isCapture())
                 {
                     // Update killer moves table
                     storeKillerMove(move, ply);
@@ -2617,7 +2624,7 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
                     updateHistoryScore(move, depth, board.getSideToMove());
 
                     // Store counter move if we have a previous move
-                    if (lastMove.from.isValid() && lastMove.to.isValid())
+                    if (!lastMove.isNull())
                     {
                         storeCounterMove(lastMove, move);
                     }
@@ -2633,7 +2640,11 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
         {
             nodeType = NodeType::EXACT;
         }
-        transpositionTable.store(hashKey, depth, maxEval, nodeType, localBestMove);
+        // Scores from a search cut short by a stop request are unreliable; keep them out of the shared TT
+        if (!searchShouldStop.load(std::memory_order_relaxed))
+        {
+            transpositionTable->store(hashKey, depth, maxEval, nodeType, localBestMove);
+        }
 
         return maxEval;
     }
@@ -2641,20 +2652,22 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
     {
         int minEval = std::numeric_limits<int>::max();
 
-        for (const auto &scoredMove : scoredMoves)
+        for (const auto &move : scoredMoves)
         {
-            const Move &move = scoredMove.second;
 
             // Save board state for unmaking move
             BoardState previousState;
 
-            // Calculate new hash key BEFORE making the move
-            uint64_t newHashKey = zobristHasher.updateHashKey(hashKey, move, board);
+            // Fetch the child's table entries while the move is made and checked
+            prefetchChild(board, move);
 
             // Make the move
-            if (!board.makeMove(move, previousState))
+            if (!board.makePseudoLegalMove(move, previousState))
                 continue;
 
+            // The board keeps its hash key up to date
+            uint64_t newHashKey = board.getHashKey();
+
             // Recursively evaluate the position
             childPV.clear();
             int eval = alphaBeta(board, depth - 1, alpha, beta, true, childPV, newHashKey, ply + 1, move);
@@ -2669,9 +2682,7 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
                 localBestMove = move;
 
                 // Update principal variation
-                pv.clear();
-                pv.push_back(move);
-                pv.insert(pv.end(), childPV.begin(), childPV.end());
+                pv.update(move, childPV);
             }
 
             // Alpha-beta pruning
@@ -2679,7 +2690,7 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
             if (beta <= alpha)
             {
                 // Store this move as a killer move if it's not a capture
-                if (board.getPieceAt(move.to) == nullptr)
+                if (!move.isCapture())
                 {
                     // Update killer moves table
                     storeKillerMove(move, ply);
@@ -2688,7 +2699,7 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
                     updateHistoryScore(move, depth, board.getSideToMove());
 
                     // Store counter move if we have a previous move
-                    if (lastMove.from.isValid() && lastMove.to.isValid())
+                    if (!lastMove.isNull())
                     {
                         storeCounterMove(lastMove, move);
                     }
@@ -2704,7 +2715,11 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
         {
             nodeType = NodeType::EXACT;
         }
-        transpositionTable.store(hashKey, depth, minEval, nodeType, localBestMove);
+        // Scores from a search cut short by a stop request are unreliable; keep them out of the shared TT
+        if (!searchShouldStop.load(std::memory_order_relaxed))
+        {
+            transpositionTable->store(hashKey, depth, minEval, nodeType, localBestMove);
+        }
 
         return minEval;
     }
@@ -2713,86 +2728,37 @@ int Engine::alphaBeta(Board &board, int depth, int alpha, int beta, bool maximiz
 // Evaluation function
 int Engine::evaluatePosition(const Board &board)
 {
-    int whiteScore = 0;
-    int blackScore = 0;
-    bool isEndgamePhase = isEndgame(board);
-
-    // MATERIAL AND POSITIONAL EVALUATION (existing code)
-    for (int row = 0; row < 8; row++)
+    // Check for checkmate and stalemate before doing any work
+    if (!board.hasLegalMove())
     {
-        for (int col = 0; col < 8; col++)
+        if (!board.isInCheck())
         {
-            Position pos(row, col);
-            auto piece = board.getPieceAt(pos);
-
-            if (!piece)
-                continue;
-
-            // Base piece value
-            int pieceValue = 0;
-            int positionalValue = 0;
-            int tableIndex = row * 8 + col;
-            int blackTableIndex = (7 - row) * 8 + col;
-
-            switch (piece->getType())
-            {
-            case PieceType::PAWN:
-                pieceValue = PAWN_VALUE;
-                positionalValue = pawnTable[piece->getColor() == Color::WHITE ? tableIndex : blackTableIndex];
-                break;
-            case PieceType::KNIGHT:
-                pieceValue = KNIGHT_VALUE;
-                positionalValue = knightTable[piece->getColor() == Color::WHITE ? tableIndex : blackTableIndex];
-                break;
-            case PieceType::BISHOP:
-                pieceValue = BISHOP_VALUE;
-                positionalValue = bishopTable[piece->getColor() == Color::WHITE ? tableIndex : blackTableIndex];
-                break;
-            case PieceType::ROOK:
-                pieceValue = ROOK_VALUE;
-                positionalValue = rookTable[piece->getColor() == Color::WHITE ? tableIndex : blackTableIndex];
-                break;
-            case PieceType::QUEEN:
-                pieceValue = QUEEN_VALUE;
-                positionalValue = queenTable[piece->getColor() == Color::WHITE ? tableIndex : blackTableIndex];
-                break;
-            case PieceType::KING:
-                pieceValue = KING_VALUE;
-                if (isEndgamePhase)
-                {
-                    positionalValue = kingEndGameTable[piece->getColor() == Color::WHITE ? tableIndex : blackTableIndex];
-                }
-                else
-                {
-                    positionalValue = kingMiddleGameTable[piece->getColor() == Color::WHITE ? tableIndex : blackTableIndex];
-                }
-                break;
-            default:
-                break;
-            }
-
-            if (piece->getColor() == Color::WHITE)
-            {
-                whiteScore += pieceValue + positionalValue;
-            }
-            else
-            {
-                blackScore += pieceValue + positionalValue;
-            }
+            return 0;
         }
+        return board.getSideToMove() == Color::WHITE ? -100000 : 100000;
     }
 
+    int whiteScore = 0;
+    int blackScore = 0;
+    bool isEndgamePhase = isEndgame(board);
+
+    // MATERIAL AND POSITIONAL EVALUATION
+    // Both sums are maintained by the board on every make/unmake; kings always
+    // come in pairs, so their value cancels and is left out of the material count
+    whiteScore += board.getMaterial(Color::WHITE) + board.getPsqScore(Color::WHITE, isEndgamePhase);
+    blackScore += board.getMaterial(Color::BLACK) + board.getPsqScore(Color::BLACK, isEndgamePhase);
+
     // NEW: ENHANCED EVALUATION COMPONENTS
     
     // 1. Piece Mobility
     int mobilityScore = evaluatePieceMobility(board);
     
-    // 2. King Safety
-    int kingSafetyScore = evaluateKingSafety(board);
-    
-    // 3. Pawn Structure
+    // 2. Pawn Structure (probes the pawn hash; king safety reuses the entry)
     int pawnStructureScore = evaluatePawnStructure(board);
     
+    // 3. King Safety
+    int kingSafetyScore = evaluateKingSafety(board);
+    
     // 4. Piece Coordination
     int coordinationScore = evaluatePieceCoordination(board);
     
@@ -2802,23 +2768,6 @@ int Engine::evaluatePosition(const Board &board)
         endgameScore = evaluateEndgameFactors(board);
     }
 
-    // Check for checkmate and stalemate
-    if (board.isCheckmate())
-    {
-        if (board.getSideToMove() == Color::WHITE)
-        {
-            return -100000;
-        }
-        else
-        {
-            return 100000;
-        }
-    }
-    else if (board.isStalemate())
-    {
-        return 0;
-    }
-
     // Calculate total score
     int materialScore = whiteScore - blackScore;
     int positionalScore = mobilityScore + kingSafetyScore + pawnStructureScore + coordinationScore + endgameScore;
@@ -2861,34 +2810,16 @@ bool Engine::shouldStopSearch() const
 
 bool Engine::isEndgame(const Board &board) const
 {
-    int pieceCount = 0;
-    bool whiteQueenPresent = false;
-    bool blackQueenPresent = false;
+    bool whiteQueenPresent = board.getPieces(Color::WHITE, PieceType::QUEEN) != 0;
+    bool blackQueenPresent = board.getPieces(Color::BLACK, PieceType::QUEEN) != 0;
 
-    // Count the number of pieces and check if queens are present
-    for (int row = 0; row < 8; row++)
+    // Count the non-pawn, non-king pieces of both sides
+    int pieceCount = 0;
+    for (Color color : {Color::WHITE, Color::BLACK})
     {
-        for (int col = 0; col < 8; col++)
-        {
-            auto piece = board.getPieceAt(Position(row, col));
-
-            if (piece && piece->getType() != PieceType::KING && piece->getType() != PieceType::PAWN)
-            {
-                pieceCount++;
-
-                if (piece->getType() == PieceType::QUEEN)
-                {
-                    if (piece->getColor() == Color::WHITE)
-                    {
-                        whiteQueenPresent = true;
-                    }
-                    else
-                    {
-                        blackQueenPresent = true;
-                    }
-                }
-            }
-        }
+        Bitboard pieces = board.getPieces(color) & ~board.getPieces(color, PieceType::PAWN) &
+                          ~board.getPieces(color, PieceType::KING);
+        pieceCount += Bitboards::popCount(pieces);
     }
 
     // Consider it an endgame if:
@@ -2941,20 +2872,14 @@ bool Engine::canUseReverseFutilityPruning(int depth, int eval, int beta) const
 
 bool Engine::canUseDeltaPruning(int eval, int alpha, const Move& move, const Board& board) const
 {
-    auto capturedPiece = board.getPieceAt(move.to);
-    if (!capturedPiece) {
+    if (!move.isCapture()) {
         return false;
     }
     
-    int captureValue = getPieceValue(capturedPiece->getType());
+    int captureValue = move.isEnPassant() ? PAWN_VALUE
+                                          : getPieceValue(board.getPieceTypeAt(move.toSquare()));
     
-    int promotionBonus = 0;
-    auto movingPiece = board.getPieceAt(move.from);
-    if (movingPiece && movingPiece->getType() == PieceType::PAWN) {
-        if (move.to.row == 0 || move.to.row == 7) {
-            promotionBonus = QUEEN_VALUE - PAWN_VALUE;
-        }
-    }
+    int promotionBonus = move.isPromotion() ? QUEEN_VALUE - PAWN_VALUE : 0;
     
     const int DELTA_PRUNING_MARGIN = 50;
     return (eval + captureValue + promotionBonus + DELTA_PRUNING_MARGIN <= alpha);
@@ -2997,8 +2922,8 @@ int Engine::getRazoringMargin(int depth, const Board& board) const
     int tacticalBonus = 0;
     
     // Count available captures and checks
-    std::vector<Move> captures;
-    generateCaptureMoves(board, captures);
+    MoveList captures;
+    board.generateCaptures(captures);
     
     if (captures.size() > 3) {
         tacticalBonus += 100; // More captures = more tactical
@@ -3305,46 +3230,64 @@ int Engine::evaluatePieceMobility(const Board& board) const
 int Engine::countPieceMobility(const Board& board, Color color) const
 {
     int totalMobility = 0;
+    const Bitboard own = board.getPieces(color);
+    const Bitboard occupied = board.getOccupied();
     
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            Position pos(row, col);
-            auto piece = board.getPieceAt(pos);
-            
-            if (!piece || piece->getColor() != color) continue;
-            
-            // Count legal moves for this piece
-            auto moves = piece->getLegalMoves(board);
-            int moveCount = moves.size();
-            
-            // Weight mobility by piece type
-            int mobilityBonus = 0;
-            switch (piece->getType()) {
-                case PieceType::KNIGHT:
-                    mobilityBonus = moveCount * MOBILITY_BONUS_KNIGHT;
-                    break;
-                case PieceType::BISHOP:
-                    mobilityBonus = moveCount * MOBILITY_BONUS_BISHOP;
-                    break;
-                case PieceType::ROOK:
-                    mobilityBonus = moveCount * MOBILITY_BONUS_ROOK;
-                    break;
-                case PieceType::QUEEN:
-                    mobilityBonus = moveCount * MOBILITY_BONUS_QUEEN;
-                    break;
-                default:
-                    // Pawns and Kings get minimal mobility bonus
-                    mobilityBonus = moveCount;
-                    break;
-            }
-            
-            totalMobility += mobilityBonus;
-            
-            // Penalty for trapped pieces (very low mobility)
-            if (moveCount <= 1 && piece->getType() != PieceType::PAWN && piece->getType() != PieceType::KING) {
-                totalMobility -= 25; // Trapped piece penalty
+    Bitboard pieces = own;
+    while (pieces) {
+        int square = Bitboards::popLsb(pieces);
+        PieceType type = board.getPieceTypeAt(square);
+        
+        // Count moves for this piece; knights and sliders straight from the attack tables
+        int moveCount = 0;
+        switch (type) {
+            case PieceType::KNIGHT:
+                moveCount = Bitboards::popCount(Bitboards::knightAttacks(square) & ~own);
+                break;
+            case PieceType::BISHOP:
+                moveCount = Bitboards::popCount(Bitboards::bishopAttacks(square, occupied) & ~own);
+                break;
+            case PieceType::ROOK:
+                moveCount = Bitboards::popCount(Bitboards::rookAttacks(square, occupied) & ~own);
+                break;
+            case PieceType::QUEEN:
+                moveCount = Bitboards::popCount(Bitboards::queenAttacks(square, occupied) & ~own);
+                break;
+            default: {
+                MoveList pieceMoves;
+                board.getPieceAt(Bitboards::fromSquare(square))->getLegalMoves(board, pieceMoves);
+                moveCount = static_cast<int>(pieceMoves.size());
+                break;
             }
         }
+        
+        // Weight mobility by piece type
+        int mobilityBonus = 0;
+        switch (type) {
+            case PieceType::KNIGHT:
+                mobilityBonus = moveCount * MOBILITY_BONUS_KNIGHT;
+                break;
+            case PieceType::BISHOP:
+                mobilityBonus = moveCount * MOBILITY_BONUS_BISHOP;
+                break;
+            case PieceType::ROOK:
+                mobilityBonus = moveCount * MOBILITY_BONUS_ROOK;
+                break;
+            case PieceType::QUEEN:
+                mobilityBonus = moveCount * MOBILITY_BONUS_QUEEN;
+                break;
+            default:
+                // Pawns and Kings get minimal mobility bonus
+                mobilityBonus = moveCount;
+                break;
+        }
+        
+        totalMobility += mobilityBonus;
+        
+        // Penalty for trapped pieces (very low mobility)
+        if (moveCount <= 1 && type != PieceType::PAWN && type != PieceType::KING) {
+            totalMobility -= 25; // Trapped piece penalty
+        }
     }
     
     return totalMobility;
@@ -3406,6 +3349,15 @@ int Engine::evaluateKingSafetyForColor(const Board& board, Color color) const
 
 int Engine::countPawnShelter(const Board& board, Position kingPos, Color kingColor) const
 {
+    // The shelter only depends on our pawns and the king square, so it is
+    // cached in the pawn hash entry, one king square per color
+    int c = (kingColor == Color::WHITE) ? 0 : 1;
+    int kingSquare = Bitboards::toSquare(kingPos);
+    PawnEntry* entry = pawnHashTable->find(board.getPawnKey());
+    if (entry && entry->kingSquare[c] == kingSquare) {
+        return entry->shelter[c];
+    }
+
     int shelterScore = 0;
     int direction = (kingColor == Color::WHITE) ? 1 : -1;
     
@@ -3430,6 +3382,10 @@ int Engine::countPawnShelter(const Board& board, Position kingPos, Color kingCol
         }
     }
     
+    if (entry) {
+        entry->kingSquare[c] = kingSquare;
+        entry->shelter[c] = shelterScore;
+    }
     return shelterScore;
 }
 
@@ -3490,15 +3446,30 @@ int Engine::evaluateKingZone(const Board& board, Position kingPos, Color kingCol
 
 int Engine::evaluatePawnStructure(const Board& board) const
 {
-    int whiteScore = evaluatePawnsForColor(board, Color::WHITE);
-    int blackScore = evaluatePawnsForColor(board, Color::BLACK);
-    
-    return (whiteScore - blackScore) * PAWN_STRUCTURE_WEIGHT;
+    return probePawnStructure(board).score * PAWN_STRUCTURE_WEIGHT;
 }
 
-int Engine::evaluatePawnsForColor(const Board& board, Color color) const
+const PawnEntry& Engine::probePawnStructure(const Board& board) const
+{
+    bool found = false;
+    PawnEntry* entry = pawnHashTable->probe(board.getPawnKey(), found);
+    if (found) {
+        return *entry;
+    }
+
+    entry->key = board.getPawnKey();
+    int whiteScore = evaluatePawnsForColor(board, Color::WHITE, entry->passed[0]);
+    int blackScore = evaluatePawnsForColor(board, Color::BLACK, entry->passed[1]);
+    entry->score = whiteScore - blackScore;
+    entry->kingSquare[0] = entry->kingSquare[1] = -1;
+    entry->shelter[0] = entry->shelter[1] = 0;
+    return *entry;
+}
+
+int Engine::evaluatePawnsForColor(const Board& board, Color color, Bitboard& passed) const
 {
     int pawnScore = 0;
+    passed = 0;
     
     // Evaluate each pawn
     for (int row = 0; row < 8; row++) {
@@ -3525,6 +3496,7 @@ int Engine::evaluatePawnsForColor(const Board& board, Color color) const
             
             // Check for pawn strengths
             if (isPawnPassed(board, pos)) {
+                passed |= Bitboards::squareBB(row * 8 + col);
                 pawnScore += PASSED_PAWN_BONUS;
                 
                 // Bonus increases as pawn advances
@@ -3611,7 +3583,7 @@ bool Engine::isPawnBackward(const Board& board, Position pawnPos) const
     Position frontPos(pawnPos.row + direction, pawnPos.col);
     if (frontPos.isValid()) {
         auto piece = board.getPieceAt(frontPos);
-        if (piece && piece->getColor() != pawnColor) {
+        if (piece && piece->getType() == PieceType::PAWN && piece->getColor() != pawnColor) {
             return true; // Blocked and cannot be defended
         }
     }
@@ -3865,7 +3837,8 @@ int Engine::evaluateKingActivity(const Board& board, Color color) const
     // King mobility
     auto king = board.getPieceAt(kingPos);
     if (king) {
-        auto moves = king->getLegalMoves(board);
+        MoveList moves;
+        king->getLegalMoves(board, moves);
         activityScore += moves.size() * 3;
     }
     
@@ -3910,261 +3883,3 @@ int Engine::evaluateKingActivity(const Board& board, Color color) const
     
     return activityScore;
 }
-
-
-// CRITICAL FIX: Safe getBestMove that prevents crashes
-Move Engine::getBestMoveSafe()
-{
-    try {
-        std::cout << "🛡️ getBestMoveSafe: Starting safe search..." << std::endl;
-        
-        // Get a copy of the board
-        Board board = game.getBoard();
-
-        // BASIC VALIDATION: Check if we have any legal moves
-        auto legalMoves = board.generateLegalMoves();
-        if (legalMoves.empty()) {
-            std::cout << "⚠️ No legal moves available" << std::endl;
-            // Return invalid move if no legal moves
-            return Move(Position(0, 0), Position(0, 0));
-        }
-
-        std::cout << "✓ Found " << legalMoves.size() << " legal moves" << std::endl;
-
-        // For maximum safety, just return the first legal move for now
-        // This bypasses all the complex search algorithms that are causing crashes
-        Move safeMove = legalMoves[0];
-        
-        // Try to find a better move if possible, but don't crash trying
-        try {
-            // Look for captures first (simple heuristic)
-            for (const auto& move : legalMoves) {
-                auto capturedPiece = board.getPieceAt(move.to);
-                if (capturedPiece) {
-                    safeMove = move; // Prefer captures
-                    break;
-                }
-            }
-        } catch (...) {
-            // If even simple move selection fails, stick with first move
-            std::cout << "⚠️ Simple move selection failed, using first legal move" << std::endl;
-        }
-        
-        std::cout << "✅ Safe move selected: " << safeMove.toString() << std::endl;
-        return safeMove;
-        
-    } catch (const std::exception& e) {
-        std::cout << "❌ Exception in getBestMoveSafe: " << e.what() << std::endl;
-        // Return a safe default move (e2e4 if possible)
-        return Move(Position(1, 4), Position(3, 4)); // e2e4
-    } catch (...) {
-        std::cout << "❌ Unknown exception in getBestMoveSafe" << std::endl;
-        return Move(Position(1, 4), Position(3, 4)); // e2e4
-    }
-}
-
-// CRITICAL FIX: Ultra-safe evaluation function
-int Engine::evaluatePositionSafe(const Board &board)
-{
-    try {
-        int whiteScore = 0;
-        int blackScore = 0;
-
-        // SIMPLIFIED material evaluation only (safest approach)
-        for (int row = 0; row < 8; row++) {
-            for (int col = 0; col < 8; col++) {
-                Position pos(row, col);
-                auto piece = board.getPieceAt(pos);
-
-                if (!piece) continue;
-
-                // Base piece value only (no positional evaluation to avoid crashes)
-                int pieceValue = 0;
-                switch (piece->getType()) {
-                    case PieceType::PAWN: pieceValue = PAWN_VALUE; break;
-                    case PieceType::KNIGHT: pieceValue = KNIGHT_VALUE; break;
-                    case PieceType::BISHOP: pieceValue = BISHOP_VALUE; break;
-                    case PieceType::ROOK: pieceValue = ROOK_VALUE; break;
-                    case PieceType::QUEEN: pieceValue = QUEEN_VALUE; break;
-                    case PieceType::KING: pieceValue = KING_VALUE; break;
-                    default: pieceValue = 0; break;
-                }
-
-                if (piece->getColor() == Color::WHITE) {
-                    whiteScore += pieceValue;
-                } else {
-                    blackScore += pieceValue;
-                }
-            }
-        }
-
-        // Simple material difference
-        int materialScore = whiteScore - blackScore;
-        
-        // Return from current side's perspective
-        return board.getSideToMove() == Color::WHITE ? materialScore : -materialScore;
-        
-    } catch (...) {
-        // Return neutral evaluation on any error
-        return 0;
-    }
-}
-
-// CRITICAL FIX: Safe killer move checking
-bool Engine::isKillerMoveSafe(const Move &move, int ply) const
-{
-    // ENHANCED bounds checking with multiple layers of protection
-    if (ply < 0 || ply >= MAX_PLY) {
-        return false;
-    }
-    
-    // Additional safety check for move validity
-    if (!move.from.isValid() || !move.to.isValid()) {
-        return false;
-    }
-
-    // SAFE: Check all 4 killer move slots with bounds protection
-    try {
-        for (int i = 0; i < 4; i++) {
-            const Move& killerMove = killerMoves[ply][i];
-            if (killerMove.from.row == move.from.row &&
-                killerMove.from.col == move.from.col &&
-                killerMove.to.row == move.to.row &&
-                killerMove.to.col == move.to.col) {
-                return true;
-            }
-        }
-    } catch (...) {
-        // If any exception occurs, safely return false
-        return false;
-    }
-    return false;
-}
-
-// CRITICAL FIX: Safe killer move storage
-void Engine::storeEnhancedKillerMoveSafe(const Move &move, int ply)
-{
-    // COMPREHENSIVE bounds checking with extra safety margins
-    if (ply < 0 || ply >= MAX_PLY) {
-        return; // Silently ignore out-of-bounds requests
-    }
-    
-    // Additional safety check for move validity
-    if (!move.from.isValid() || !move.to.isValid()) {
-        return;
-    }
-
-    try {
-        // Don't store if it's already the first killer move
-        if (killerMoves[ply][0].from.row == move.from.row &&
-            killerMoves[ply][0].from.col == move.from.col &&
-            killerMoves[ply][0].to.row == move.to.row &&
-            killerMoves[ply][0].to.col == move.to.col)
-        {
-            return;
-        }
-
-        // SAFE: Shift killer moves to make room for the new one (4 slots)
-        for (int i = 3; i > 0; i--) {
-            killerMoves[ply][i] = killerMoves[ply][i-1];
-        }
-        killerMoves[ply][0] = move;
-    } catch (...) {
-        // If any exception occurs during storage, silently ignore
-        return;
-    }
-}
-
-// CRITICAL FIX: Safe history score access
-int Engine::getHistoryScoreSafe(const Move &move, Color color) const
-{
-    try {
-        int colorIdx = (color == Color::WHITE) ? 0 : 1;
-        int fromIdx = SAFE_ARRAY_ACCESS(move.from.row * 8 + move.from.col, 64);
-        int toIdx = SAFE_ARRAY_ACCESS(move.to.row * 8 + move.to.col, 64);
-
-        // Bounds check the indices
-        if (colorIdx >= 0 && colorIdx < 2 && fromIdx >= 0 && fromIdx < 64 && toIdx >= 0 && toIdx < 64) {
-            return historyTable[colorIdx][fromIdx][toIdx];
-        }
-    } catch (...) {
-        // Return safe default on any error
-    }
-    return 0; // Safe default
-}
-
-// CRITICAL FIX: Safe butterfly score access
-int Engine::getButterflyScoreSafe(const Move &move) const
-{
-    try {
-        int fromIdx = SAFE_ARRAY_ACCESS(move.from.row * 8 + move.from.col, 64);
-        int toIdx = SAFE_ARRAY_ACCESS(move.to.row * 8 + move.to.col, 64);
-        
-        if (fromIdx >= 0 && fromIdx < 64 && toIdx >= 0 && toIdx < 64) {
-            return butterflyHistory[fromIdx][toIdx];
-        }
-    } catch (...) {
-        // Return safe default on any error
-    }
-    return 0; // Safe default
-}
-
-// CRITICAL FIX: Safe updateHistoryScore with overflow protection
-void Engine::updateHistoryScoreSafe(const Move &move, int depth, Color color)
-{
-    try {
-        int colorIdx = (color == Color::WHITE) ? 0 : 1;
-        int fromIdx = SAFE_ARRAY_ACCESS(move.from.row * 8 + move.from.col, 64);
-        int toIdx = SAFE_ARRAY_ACCESS(move.to.row * 8 + move.to.col, 64);
-
-        // Bounds check all indices
-        if (colorIdx < 0 || colorIdx >= 2 || fromIdx < 0 || fromIdx >= 64 || toIdx < 0 || toIdx >= 64) {
-            return; // Silently ignore invalid indices
-        }
-
-        // Calculate bonus with overflow protection
-        int bonus = std::min(depth * depth, 512); // Cap individual bonuses
-        
-        // Check for potential overflow BEFORE adding
-        const int MAX_HISTORY_SCORE = 8192; // Reduced maximum to be extra safe
-        
-        if (historyTable[colorIdx][fromIdx][toIdx] > MAX_HISTORY_SCORE - bonus) {
-            // Scale down ALL entries to prevent overflow
-            for (int c = 0; c < 2; c++) {
-                for (int from = 0; from < 64; from++) {
-                    for (int to = 0; to < 64; to++) {
-                        historyTable[c][from][to] = historyTable[c][from][to] / 2;
-                    }
-                }
-            }
-        }
-        
-        // Now safely add the bonus
-        historyTable[colorIdx][fromIdx][toIdx] += bonus;
-        
-        // Final safety check
-        if (historyTable[colorIdx][fromIdx][toIdx] > MAX_HISTORY_SCORE) {
-            historyTable[colorIdx][fromIdx][toIdx] = MAX_HISTORY_SCORE;
-        }
-    } catch (...) {
-        // Silently ignore any errors in history updates
-        return;
-    }
-}
-
-// CRITICAL FIX: Placeholder safe search methods (implement when main methods work)
-Move Engine::iterativeDeepeningSearchSafe(Board &board, int maxDepth, uint64_t hashKey)
-{
-    // For now, just return the first legal move
-    auto legalMoves = board.generateLegalMoves();
-    return legalMoves.empty() ? Move(Position(0,0), Position(0,0)) : legalMoves[0];
-}
-
-int Engine::pvSearchSafe(Board &board, int depth, int alpha, int beta, bool maximizingPlayer,
-                        std::vector<Move> &pv, uint64_t hashKey, int ply, Move lastMove)
-{
-    // For now, just return a simple evaluation
-    pv.clear();
-    return evaluatePositionSafe(board);
-}
-
@@ -4,40 +4,89 @@
 #include "common.h"
 #include "game.h"
 #include "transposition.h"
+#include "pawn_hash.h"
 #include "zobrist.h"
+#include "psqt.h"
+#include "move_picker.h"
 #include <mutex>
 #include <atomic>
-#include <unordered_map>
+#include <thread>
+#include <functional>
 
 // Maximum search depth - adjust if needed
 #define MAX_PLY 64
-#define MAX_QSEARCH_DEPTH 8
+
+// How a reported score relates to the true score (white's point of view)
+enum class ScoreBound
+{
+    EXACT, // Completed iteration
+    LOWER, // Aspiration search failed high: the score is at least this
+    UPPER  // Aspiration search failed low: the score is at most this
+};
+
+// Progress report handed to the search listener while a search runs
+struct SearchInfo
+{
+    int depth;              // Iteration depth
+    int selDepth;           // Deepest ply reached, including quiescence
+    int score;              // Score of the iteration (0 for progress-only reports)
+    ScoreBound bound;       // LOWER/UPPER for aspiration fail reports
+    long nodes;             // Nodes searched so far
+    long timeMs;            // Time since the search started
+    long nps;               // Nodes per second
+    int hashfull;           // Transposition table usage in permille
+    PVLine pv;              // Principal variation (empty for progress-only reports)
+    bool iterationComplete; // False for aspiration fail reports and the periodic mid-iteration ones
+};
 
 class Engine
 {
+    // Orders the moves of a node from the killer, counter move and history tables
+    friend class MovePicker;
+
 private:
     // CORE ENGINE DATA
     int maxDepth;
     Game &game;
-    TranspositionTable transpositionTable;
-    Zobrist zobristHasher;
+    std::shared_ptr<TranspositionTable> transpositionTable; // Shared with helper threads
+    std::unique_ptr<PawnHashTable> pawnHashTable;           // One per thread, never shared
+
+    // LAZY SMP: helper engines that search the same root on their own threads.
+    // Each helper has its own killers/history/PV and shares the TT above.
+    static const int MAX_THREADS = 256;
+    std::vector<std::unique_ptr<Engine>> helpers;
+    int helperIndex; // 0 for the main engine, 1..N-1 for helpers
+
+    // Result of the deepest fully completed iteration of the last search
+    Move completedBestMove;
+    int completedScore;
+    int completedDepth;
+
+    // This engine's (and so this thread's) copy of the root position. The
+    // search makes and unmakes moves on it, with one undo entry per ply.
+    Board searchBoard;
+    BoardState undoStack[MAX_PLY];
 
     // PRINCIPAL VARIATION (PV) STORAGE
-    std::vector<Move> principalVariation;
-    std::vector<std::vector<Move>> pvTable; // Stores PV for each depth
+    PVLine principalVariation;
+    std::vector<PVLine> pvTable; // Stores PV for each depth, sized to MAX_PLY
 
     // ENHANCED: KILLER MOVE TABLES - 4 slots instead of 2
     Move killerMoves[MAX_PLY][4];
 
-   Move* counterMovesPtr; // Dynamic allocation to avoid stack overflow
+    // The large per-engine tables live on the heap so an Engine stays small
+    // enough to construct on any thread's stack
+
+    // COUNTER MOVE TABLE
+    static const int COUNTER_MOVE_ENTRIES = 6 * 2 * 64 * 64;
+    std::unique_ptr<Move[]> counterMoves; // [piece_type][color][from_square][to_square]
 
     // HISTORY HEURISTIC TABLE
-    int historyTable[2][64][64]; // [color][from_square][to_square]
+    std::unique_ptr<int[][64][64]> historyTable; // [color][from_square][to_square]
 
     // ENHANCED MOVE ORDERING STRUCTURES
-    int butterflyHistory[64][64];                    // [from_square][to_square]
+    std::unique_ptr<int[][64]> butterflyHistory;    // [from_square][to_square]
     Move countermoveHistory[6][64];                  // [piece_type][to_square]
-    mutable std::unordered_map<uint64_t, int> seeCache;      // SEE cache for performance
 
     // NULL MOVE PRUNING TRACKING
     bool nullMoveAllowed[MAX_PLY];  // Track null move usage per ply
@@ -61,9 +110,11 @@ private:
     mutable long pruningStats[5];                    // Stats: [null_move, razoring, futility, lmr, conflicts]
 
     // TIME MANAGEMENT VARIABLES
-    int timeAllocated; // time in milliseconds allocated for this move
+    // timeAllocated/timeManaged are atomic because ponderhit changes them
+    // from the UCI thread while the search is running
+    std::atomic<int> timeAllocated; // time in milliseconds allocated for this move
     int timeBuffer;    // safety buffer to avoid timeout
-    bool timeManaged;  // whether to use time management
+    std::atomic<bool> timeManaged;  // whether to use time management
     mutable std::mutex timeMutex;
     std::atomic<bool> searchShouldStop{false};
     std::atomic<bool> timeManagementActive{false};
@@ -72,9 +123,27 @@ private:
     bool positionIsUnstable;
     int unstableExtensionPercent; // Additional percentage of time for unstable positions
 
+    // SEARCH LIMITS (UCI go nodes / go mate)
+    long nodeLimit; // 0 = unlimited
+    int mateLimit;  // Stop once a mate in this many moves is found, 0 = off
+
+    // Prefetch each child's TT cluster and pawn hash entry before making the move
+    bool prefetchEnabled;
+
+    // Keep the per-depth progress lines off stdout (for engines run by a server)
+    bool quiet;
+
+    // SEARCH PROGRESS REPORTING
+    std::function<void(const SearchInfo &)> searchListener;
+    int selDepth;
+    int currentIterationDepth;
+    std::chrono::time_point<std::chrono::high_resolution_clock> lastProgressReport;
+
 public:
     Engine(Game &g, int depth = 3, int ttSizeMB = 64, bool useTimeManagement = false);
-    ~Engine();
+
+    // Engine that uses an existing transposition table, e.g. one shared by an EnginePool
+    Engine(Game &g, int depth, std::shared_ptr<TranspositionTable> sharedTT);
 
     void setTimeAllocation(int timeInMs)
     {
@@ -92,36 +161,93 @@ public:
     // Enable/disable time management
     void setTimeManagement(bool enabled) { timeManaged = enabled; }
 
+    // Stop after roughly this many nodes (0 = no limit)
+    void setNodeLimit(long nodes) { nodeLimit = nodes; }
+
+    // Stop as soon as a mate in this many moves is found (0 = off)
+    void setMateLimit(int moves) { mateLimit = moves; }
+
+    // Drop time, node and mate limits left over from a previous search
+    void clearSearchLimits();
+
+    // Ask a running search to stop; safe to call from another thread
+    void stop() { searchShouldStop.store(true); }
+
+    // Drop a stop request left over from an earlier search
+    void clearStop() { searchShouldStop.store(false); }
+
+    // The pondered move was played: from now on the search is on the clock.
+    // timeMs is measured from the start of the search.
+    void ponderHit(int timeMs);
+
+    // Called after every completed iteration, whenever an aspiration window
+    // fails and the iteration is searched again, and about once a second in between
+    void setSearchListener(std::function<void(const SearchInfo &)> listener) { searchListener = std::move(listener); }
+
     // Set the search depth
     void setDepth(int depth) { maxDepth = depth; }
 
     // Set transposition table size
-    void setTTSize(int sizeMB) { transpositionTable.resize(sizeMB); }
+    bool setTTSize(int sizeMB) { return transpositionTable->resize(sizeMB); }
 
-    // Calculate the best move for the current position
-    Move getBestMove();
+    // Set the pawn hash table size (per search thread)
+    void setPawnHashSize(int sizeMB);
 
-    // CRITICAL FIX: Crash-safe version of getBestMove
-    Move getBestMoveSafe();
+    // Turn child prefetching on or off (on by default), for benchmarking
+    void setPrefetch(bool enabled);
+
+    // Search without printing a line per depth when no listener is installed
+    void setQuiet(bool enabled) { quiet = enabled; }
+
+    // Share of pawn hash probes answered from the table in the last search, in percent
+    double getPawnHashHitRate() const;
+
+    // Set the number of search threads (1 = single-threaded)
+    void setThreads(int threads);
+    int getThreads() const { return static_cast<int>(helpers.size()) + 1; }
+
+    // Calculate the best move for the current position. Any earlier stop request
+    // is dropped first, unless keepPendingStop is set: a caller that runs the
+    // search on another thread calls clearStop() before starting it, so that a
+    // stop() sent before the search gets going is not lost.
+    Move getBestMove(bool keepPendingStop = false);
 
     // Clear the transposition table
-    void clearTT() { transpositionTable.clear(); }
+    void clearTT() { transpositionTable->clear(); }
+
+    // Save the transposition table to a snapshot file, or replace it with one
+    bool saveTT(const std::string &path) const { return transpositionTable->save(path); }
+    bool loadTT(const std::string &path) { return transpositionTable->load(path); }
+
+    // Size of the transposition table in megabytes
+    int getTTSizeMB() const { return static_cast<int>(transpositionTable->getSize() * sizeof(TTSlot) / (1024 * 1024)); }
+
+    // The table itself, for reporting how it is allocated and how fast it is
+    const TranspositionTable &getTranspositionTable() const { return *transpositionTable; }
+
+    // Forget what earlier searches taught the move ordering (killers, counter
+    // moves, history) and drop search limits. The TT is kept.
+    void resetHeuristics();
 
     // Get the principal variation as a string
     std::string getPVString() const;
+    const PVLine &getPrincipalVariation() const { return principalVariation; }
 
     // Get the number of nodes searched
     long getNodesSearched() const { return nodesSearched; }
 
+    // Score of the deepest completed iteration of the last search (white's point of view)
+    int getLastScore() const { return completedScore; }
+
+    // Depth of that iteration
+    int getLastDepth() const { return completedDepth; }
+
     // Reset search statistics
     void resetStats() { nodesSearched = 0; }
     
     // FIXED: Public evaluation methods for testing - these were causing the compilation errors
     int evaluatePosition(const Board &board);
     
-    // CRITICAL FIX: Crash-safe version of evaluatePosition
-    int evaluatePositionSafe(const Board &board);
-    
     int evaluatePieceMobility(const Board& board) const;
     int evaluateKingSafety(const Board& board) const;
     int evaluatePawnStructure(const Board& board) const;
@@ -160,13 +286,13 @@ static inline const double LMR_POSITION_FACTOR = 0.3;
     static const bool ENABLE_LMR = true;
     static const int PRUNING_CONFLICT_THRESHOLD = 2; // Max pruning techniques per node    
 
-    // PIECE VALUES
-    static const int PAWN_VALUE = 100;
-    static const int KNIGHT_VALUE = 320;
-    static const int BISHOP_VALUE = 330;
-    static const int ROOK_VALUE = 500;
-    static const int QUEEN_VALUE = 900;
-    static const int KING_VALUE = 20000;
+    // PIECE VALUES (shared with the board's incremental material count)
+    static const int PAWN_VALUE = PSQT::PAWN_VALUE;
+    static const int KNIGHT_VALUE = PSQT::KNIGHT_VALUE;
+    static const int BISHOP_VALUE = PSQT::BISHOP_VALUE;
+    static const int ROOK_VALUE = PSQT::ROOK_VALUE;
+    static const int QUEEN_VALUE = PSQT::QUEEN_VALUE;
+    static const int KING_VALUE = PSQT::KING_VALUE;
 
     // NEW: EVALUATION WEIGHTS
     static const int MOBILITY_WEIGHT = 4;
@@ -199,31 +325,36 @@ static inline const double LMR_POSITION_FACTOR = 0.3;
     static const int MOBILITY_BONUS_ROOK = 2;
     static const int MOBILITY_BONUS_QUEEN = 1;
 
-    // PIECE-SQUARE TABLES
-    static const int pawnTable[64];
-    static const int knightTable[64];
-    static const int bishopTable[64];
-    static const int rookTable[64];
-    static const int queenTable[64];
-    static const int kingMiddleGameTable[64];
-    static const int kingEndGameTable[64];
+    // Helper engine constructor: shares the TT, stays quiet on stdout
+    Engine(Game &g, int depth, std::shared_ptr<TranspositionTable> sharedTT, int index);
+
+    // Zero the heuristic tables (shared by both constructors)
+    void initializeTables();
+
+    // Reset per-search counters and flags before a new search
+    void prepareSearch();
+
+    // Run helpers alongside the main search and pick the strongest result
+    Move lazySMPSearch(Board &board, uint64_t hashKey);
+
+    // Send a SearchInfo to the listener (main thread only)
+    void reportProgress(int depth, int score, bool iterationComplete,
+                        ScoreBound bound = ScoreBound::EXACT, const PVLine *pv = nullptr);
 
     // CORE SEARCH METHODS
     Move iterativeDeepeningSearch(Board &board, int maxDepth, uint64_t hashKey);
     int pvSearch(Board &board, int depth, int alpha, int beta, bool maximizingPlayer,
-                 std::vector<Move> &pv, uint64_t hashKey, int ply, Move lastMove);
+                 PVLine &pv, uint64_t hashKey, int ply, Move lastMove);
     int alphaBeta(Board &board, int depth, int alpha, int beta, bool maximizingPlayer,
-                  std::vector<Move> &pv, uint64_t hashKey, int ply, Move lastMove);
+                  PVLine &pv, uint64_t hashKey, int ply, Move lastMove);
     int quiescenceSearch(Board &board, int alpha, int beta, uint64_t hashKey, int ply);
 
-    // CRITICAL FIX: Safe search methods to prevent crashes
-    Move iterativeDeepeningSearchSafe(Board &board, int maxDepth, uint64_t hashKey);
-    int pvSearchSafe(Board &board, int depth, int alpha, int beta, bool maximizingPlayer,
-                    std::vector<Move> &pv, uint64_t hashKey, int ply, Move lastMove);
-
     // NEW: Individual Evaluation Components
     int evaluateKingSafetyForColor(const Board& board, Color color) const;
-    int evaluatePawnsForColor(const Board& board, Color color) const;
+    int evaluatePawnsForColor(const Board& board, Color color, Bitboard& passed) const;
+
+    // Pawn hash entry for the board's pawns, computed and stored on a miss
+    const PawnEntry& probePawnStructure(const Board& board) const;
     int evaluatePieceActivity(const Board& board, Color color) const;
     int evaluateKingActivity(const Board& board, Color color) const;
 
@@ -243,26 +374,19 @@ static inline const double LMR_POSITION_FACTOR = 0.3;
     int countKingAttackers(const Board& board, Position kingPos, Color attackerColor) const;
     int evaluateKingZone(const Board& board, Position kingPos, Color kingColor) const;
 
-    // MOVE GENERATION METHODS
-    void generateCaptureMoves(const Board& board, std::vector<Move>& captures) const;
-    void generatePawnCaptures(const Board& board, Position from, std::vector<Move>& captures) const;
-    void generateKnightCaptures(const Board& board, Position from, std::vector<Move>& captures) const;
-    void generateBishopCaptures(const Board& board, Position from, std::vector<Move>& captures) const;
-    void generateRookCaptures(const Board& board, Position from, std::vector<Move>& captures) const;
-    void generateQueenCaptures(const Board& board, Position from, std::vector<Move>& captures) const;
-    void generateKingCaptures(const Board& board, Position from, std::vector<Move>& captures) const;
-    void generateCheckEvasions(const Board& board, std::vector<Move>& evasions) const;
-    void generatePromotions(const Board& board, std::vector<Move>& promotions) const;
-
     // STATIC EXCHANGE EVALUATION (SEE)
     int seeCapture(const Board &board, const Move &move) const;
-    int see(const Board &board, const Position &square, Color side, int capture_value) const;
+    bool seeGE(const Board &board, const Move &move, int threshold) const;
     int getPieceValue(PieceType type) const;
 
     // MOVE ORDERING AND SCORING
     int getMoveScore(const Move &move, const Board &board, const Move &ttMove,
-                     const std::vector<Move> &pv, int ply, Color sideToMove,
+                     const PVLine &pv, int ply, Color sideToMove,
                      const Move &lastMove) const;
+    // Ordering scores within the MovePicker stages
+    int getCaptureScore(const Move &move, const Board &board) const;
+    int getQuietMoveScore(const Move &move, const Board &board, Color sideToMove) const;
+
     int getEnhancedMoveScore(const Move& move, const Board& board, const Move& ttMove,
                            int ply, Color sideToMove, const Move& lastMove) const;
     int getMVVLVAScore(PieceType attacker, PieceType victim) const;
@@ -273,9 +397,9 @@ static inline const double LMR_POSITION_FACTOR = 0.3;
     void storeEnhancedKillerMove(const Move &move, int ply);
     bool isKillerMove(const Move &move, int ply) const;
 
-    // CRITICAL FIX: Safe killer move methods to prevent array bounds crashes
-    bool isKillerMoveSafe(const Move &move, int ply) const;
-    void storeEnhancedKillerMoveSafe(const Move &move, int ply);
+    // Prefetch the TT cluster and pawn hash entry of the position after move,
+    // before the move is made
+    void prefetchChild(const Board &board, const Move &move) const;
 
     // COUNTER MOVE MANAGEMENT
     void storeCounterMove(const Move &lastMove, const Move &counterMove);
@@ -287,10 +411,6 @@ static inline const double LMR_POSITION_FACTOR = 0.3;
     void updateHistoryScore(const Move &move, int depth, Color color);
     int getHistoryScore(const Move &move, Color color) const;
     
-    // CRITICAL FIX: Safe history methods to prevent array bounds crashes
-    int getHistoryScoreSafe(const Move &move, Color color) const;
-    void updateHistoryScoreSafe(const Move &move, int depth, Color color);
-    
     // Extension methods
     int calculateExtensions(const Move& move, const Board& board, int depth, int ply, 
                            bool isPVNode, bool inCheck, int moveNumber) const;
@@ -318,14 +438,14 @@ static inline const double LMR_POSITION_FACTOR = 0.3;
     // BUTTERFLY HISTORY MANAGEMENT
     void updateButterflyHistory(const Move &move, int depth, Color color);
     int getButterflyScore(const Move &move) const;
-    
-    // CRITICAL FIX: Safe butterfly history method
-    int getButterflyScoreSafe(const Move &move) const;
 
     // PRINCIPAL VARIATION MANAGEMENT
-    void storePV(int depth, const std::vector<Move> &pv);
+    void storePV(int depth, const PVLine &pv);
     bool isPVMove(const Move &move, int depth, int ply) const;
-    bool isPVMove(const Move &move, const std::vector<Move> &pv, int ply) const;
+    bool isPVMove(const Move &move, const PVLine &pv, int ply) const;
+
+    // The move at ply in the deepest stored PV that reaches it, or the null move
+    Move getPVMove(int ply) const;
 
     // LATE MOVE REDUCTION (LMR) - Enhanced
     int calculateLMRReduction(int depth, int moveIndex, bool foundPV, bool isCapture,
@@ -349,7 +469,6 @@ static inline const double LMR_POSITION_FACTOR = 0.3;
     void clearCounterMoves();
     void clearHistoryTable();
     void clearEnhancedTables();
-    void clearSEECache();
 
     // Parameter Tuning Framework - moved some methods to public section above
     struct TuningParameter {
@@ -2,6 +2,7 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
+#include <cctype>
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include "game.h"
@@ -9,64 +10,90 @@
 
 #pragma comment(lib, "ws2_32.lib")
 
-class SafeEngineBridge {
+class EngineBridge {
 private:
     Game game;
     Engine engine;
     
 public:
-    SafeEngineBridge() : engine(game, 1) {  // Start with depth 1 for safety
-        std::cout << "Safe Engine Bridge initialized with depth 1!" << std::endl;
+    static const int DEFAULT_DEPTH = 6;
+
+    EngineBridge() : engine(game, DEFAULT_DEPTH) {
+        std::cout << "Engine Bridge initialized (default depth " << DEFAULT_DEPTH << ")" << std::endl;
     }
     
     std::string getEngineMove(const std::string& fen, int depth) {
         try {
             std::cout << "=== ENGINE MOVE REQUEST ===" << std::endl;
-            std::cout << "Requested depth: " << depth << std::endl;
-            
-            // Use minimal depth
-            if (depth > 1) depth = 1;
-            std::cout << "Using safe depth: " << depth << std::endl;
-            
-            // Use starting position for now
-            std::cout << "Setting up starting position..." << std::endl;
-            game.newGame();
-            std::cout << "✓ Game initialized" << std::endl;
+            std::cout << "FEN: " << fen << std::endl;
+            std::cout << "Depth: " << depth << std::endl;
             
-            // SKIP EVALUATION - it's causing the crash
-            std::cout << "Skipping evaluation test..." << std::endl;
-            
-            std::cout << "Setting engine depth..." << std::endl;
+            game.newGameFromFEN(fen);
             engine.setDepth(depth);
-            std::cout << "✓ Depth set to " << depth << std::endl;
             
-            std::cout << "Calling getBestMove()..." << std::endl;
             Move bestMove = engine.getBestMove();
-            std::cout << "✓ Got best move!" << std::endl;
             
-            // Validate the move
-            if (!bestMove.from.isValid() || !bestMove.to.isValid()) {
-                std::cout << "WARNING: Invalid move returned!" << std::endl;
-                return "{\"move\":\"e2e4\",\"eval\":0,\"error\":\"Invalid move\"}";
+            // No legal moves: checkmate or stalemate
+            if (bestMove.isNull()) {
+                return "{\"move\":null,\"eval\":0,\"error\":\"No legal moves\"}";
             }
             
-            std::string moveStr = bestMove.from.toString() + bestMove.to.toString();
-            std::cout << "✓ Move string: " << moveStr << std::endl;
-            
-            std::cout << "=== SUCCESS ===" << std::endl;
+            std::string moveStr = bestMove.toString();
+            int eval = engine.getLastScore();
+            std::cout << "Engine move: " << moveStr << " (eval: " << eval << ")" << std::endl;
             
-            return "{\"move\":\"" + moveStr + "\",\"eval\":0}";
+            return "{\"move\":\"" + moveStr + "\",\"eval\":" + std::to_string(eval) + "}";
             
         } catch (const std::exception& e) {
-            std::cout << "❌ ENGINE EXCEPTION: " << e.what() << std::endl;
-            return "{\"move\":\"e2e4\",\"eval\":0,\"error\":\"Exception: " + std::string(e.what()) + "\"}";
-        } catch (...) {
-            std::cout << "❌ UNKNOWN ENGINE ERROR" << std::endl;
-            return "{\"move\":\"e2e4\",\"eval\":0,\"error\":\"Unknown crash\"}";
+            std::cout << "ENGINE EXCEPTION: " << e.what() << std::endl;
+            return "{\"move\":null,\"eval\":0,\"error\":\"Exception: " + std::string(e.what()) + "\"}";
         }
     }
 };
 
+// Decode %XX escapes and '+' in a query-string value
+std::string urlDecode(const std::string& str) {
+    std::string decoded;
+    for (size_t i = 0; i < str.length(); i++) {
+        if (str[i] == '%' && i + 2 < str.length() &&
+            std::isxdigit(static_cast<unsigned char>(str[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(str[i + 2]))) {
+            decoded += static_cast<char>(std::stoi(str.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else if (str[i] == '+') {
+            decoded += ' ';
+        } else {
+            decoded += str[i];
+        }
+    }
+    return decoded;
+}
+
+// Value of a query parameter in the request line, or "" if absent
+std::string queryParam(const std::string& request, const std::string& name) {
+    size_t lineEnd = request.find("\r\n");
+    std::string requestLine = request.substr(0, lineEnd);
+    
+    size_t queryStart = requestLine.find('?');
+    if (queryStart == std::string::npos) return "";
+    
+    size_t pos = queryStart + 1;
+    while (pos < requestLine.length()) {
+        size_t end = requestLine.find_first_of("& ", pos);
+        if (end == std::string::npos) end = requestLine.length();
+        
+        std::string pair = requestLine.substr(pos, end - pos);
+        size_t eq = pair.find('=');
+        if (eq != std::string::npos && pair.substr(0, eq) == name) {
+            return urlDecode(pair.substr(eq + 1));
+        }
+        
+        if (end >= requestLine.length() || requestLine[end] == ' ') break;
+        pos = end + 1;
+    }
+    return "";
+}
+
 std::string httpResponse(const std::string& content) {
     std::stringstream response;
     response << "HTTP/1.1 200 OK\r\n";
@@ -80,15 +107,28 @@ std::string httpResponse(const std::string& content) {
 }
 
 std::string handleRequest(const std::string& request) {
-    static SafeEngineBridge bridge;
+    static EngineBridge bridge;
     
     if (request.find("GET /status") == 0) {
-        return httpResponse("{\"status\":\"Safe Engine Bridge Ready\"}");
+        return httpResponse("{\"status\":\"Engine Bridge Ready\"}");
     }
     
     if (request.find("GET /move") == 0) {
-        std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
-        int depth = 1;  // Safe depth
+        std::string fen = queryParam(request, "fen");
+        if (fen.empty()) {
+            fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        }
+        
+        int depth = EngineBridge::DEFAULT_DEPTH;
+        std::string depthStr = queryParam(request, "depth");
+        if (!depthStr.empty()) {
+            try {
+                depth = std::stoi(depthStr);
+            } catch (...) {
+                depth = EngineBridge::DEFAULT_DEPTH;
+            }
+        }
+        depth = std::max(1, std::min(depth, MAX_PLY - 1));
         
         return httpResponse(bridge.getEngineMove(fen, depth));
     }
@@ -97,7 +137,7 @@ std::string handleRequest(const std::string& request) {
 }
 
 int main() {
-    std::cout << "🛡️ SAFE ENGINE BRIDGE STARTING! 🛡️" << std::endl;
+    std::cout << "Engine Bridge starting" << std::endl;
     
     WSADATA wsaData;
     if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
@@ -131,8 +171,7 @@ int main() {
         return 1;
     }
     
-    std::cout << "✅ Safe server listening on port 8080" << std::endl;
-    std::cout << "Ready for safe chess engine testing!" << std::endl;
+    std::cout << "Engine Bridge listening on port 8080" << std::endl;
     
     while (true) {
         sockaddr_in clientAddr;
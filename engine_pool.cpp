@@ -0,0 +1,89 @@
+#include "engine_pool.h"
+
+EnginePool::EnginePool(const Options& options) {
+    int count = std::max(1, options.size);
+
+    if (options.sharedTT) {
+        sharedTable = std::make_shared<TranspositionTable>(options.ttSizeMB);
+    }
+
+    for (int i = 0; i < count; i++) {
+        std::unique_ptr<Slot> slot(new Slot());
+        if (sharedTable) {
+            slot->engine.reset(new Engine(slot->game, options.depth, sharedTable));
+        } else {
+            slot->engine.reset(new Engine(slot->game, options.depth, options.ttSizeMB));
+        }
+        // Pooled engines serve requests; their results go back in the responses
+        slot->engine->setQuiet(true);
+        slots.push_back(std::move(slot));
+        freeSlots.push_back(i);
+    }
+}
+
+EnginePool::Lease EnginePool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    slotReturned.wait(lock, [this] { return !freeSlots.empty(); });
+    int index = freeSlots.back();
+    freeSlots.pop_back();
+    return Lease(this, index);
+}
+
+int EnginePool::available() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(freeSlots.size());
+}
+
+void EnginePool::release(int index) {
+    // Reset outside the lock; nobody else can reach this slot until it is listed as free
+    Slot& slot = *slots[index];
+    slot.engine->resetHeuristics();
+    slot.engine->setSearchListener(nullptr);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeSlots.push_back(index);
+    }
+    slotReturned.notify_one();
+}
+
+EnginePool::Lease::Lease(Lease&& other) noexcept : pool(other.pool), index(other.index) {
+    other.pool = nullptr;
+}
+
+EnginePool::Lease::~Lease() {
+    if (pool) {
+        pool->release(index);
+    }
+}
+
+Engine& EnginePool::Lease::engine() {
+    return *pool->slots[index]->engine;
+}
+
+Game& EnginePool::Lease::game() {
+    return pool->slots[index]->game;
+}
+
+bool EnginePool::Lease::setPosition(const std::string& fen, std::string& error) {
+    Game& leasedGame = game();
+    leasedGame.newGameFromFEN(fen);
+    return checkPosition(leasedGame.getBoard(), fen, error);
+}
+
+bool EnginePool::checkPosition(const Board& board, const std::string& fen, std::string& error) {
+    std::string requested = fen.substr(0, fen.find(' '));
+    std::string loaded = board.toFEN();
+    loaded = loaded.substr(0, loaded.find(' '));
+    if (requested != loaded) {
+        error = "Invalid FEN";
+        return false;
+    }
+
+    if (Bitboards::popCount(board.getPieces(Color::WHITE, PieceType::KING)) != 1 ||
+        Bitboards::popCount(board.getPieces(Color::BLACK, PieceType::KING)) != 1) {
+        error = "Position must have exactly one king per side";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+#ifndef ENGINE_POOL_H
+#define ENGINE_POOL_H
+
+#include "game.h"
+#include "engine.h"
+#include <mutex>
+#include <condition_variable>
+
+// A fixed set of engines built once at startup. A request checks one out,
+// sets its position and searches, and the engine goes back to the pool when
+// the lease ends. Returning an engine resets its move-ordering heuristics and
+// search limits, so a request never sees killers or history from another one;
+// only the transposition table (a position-keyed cache) carries over.
+class EnginePool
+{
+public:
+    struct Options
+    {
+        int size = 1;
+        int depth = 6;        // Default search depth of every engine
+        int ttSizeMB = 16;    // Per engine, or in total when sharedTT is set
+        bool sharedTT = false; // One TT for the whole pool instead of one per engine
+    };
+
+    // Exclusive use of one engine and its game; returns it to the pool on destruction
+    class Lease
+    {
+    public:
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) = delete;
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        ~Lease();
+
+        Engine &engine();
+        Game &game();
+
+        // Load a FEN into the leased game; false with a reason (see checkPosition)
+        bool setPosition(const std::string &fen, std::string &error);
+
+    private:
+        friend class EnginePool;
+        Lease(EnginePool *pool, int index) : pool(pool), index(index) {}
+
+        EnginePool *pool;
+        int index;
+    };
+
+    explicit EnginePool(const Options &options);
+
+    // Check out an engine, waiting for one to come back if all are in use
+    Lease acquire();
+
+    int size() const { return static_cast<int>(slots.size()); }
+    int available() const;
+
+    // The table all engines share, or nullptr unless Options::sharedTT was set
+    TranspositionTable *getSharedTT() const { return sharedTable.get(); }
+
+    // Check that board holds the position fen describes. Board::setupFromFEN
+    // falls back to the starting position on bad input; this reports that (and
+    // positions without one king per side) as an error instead.
+    static bool checkPosition(const Board &board, const std::string &fen, std::string &error);
+
+private:
+    struct Slot
+    {
+        Game game;
+        std::unique_ptr<Engine> engine;
+    };
+
+    std::shared_ptr<TranspositionTable> sharedTable;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<int> freeSlots;
+    mutable std::mutex mutex;
+    std::condition_variable slotReturned;
+
+    void release(int index);
+};
+
+#endif // ENGINE_POOL_H
@@ -0,0 +1,218 @@
+#include "engine_service.h"
+#include <sstream>
+#include <fstream>
+
+namespace {
+
+const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+HttpResponse jsonError(int status, const std::string& message) {
+    return HttpResponse(status, "{\"error\":\"" + jsonEscape(message) + "\"}");
+}
+
+// One update of an /analyze stream, as a server-sent event or a JSON line
+std::string streamEvent(bool sse, const std::string& type, const std::string& json) {
+    if (sse) {
+        return "event: " + type + "\ndata: " + json + "\n\n";
+    }
+    return "{\"type\":\"" + type + "\"," + json.substr(1) + "\n";
+}
+
+std::string searchInfoJson(const SearchInfo& info) {
+    std::ostringstream out;
+    out << "{\"depth\":" << info.depth;
+    if (info.iterationComplete || info.bound != ScoreBound::EXACT) {
+        out << ",\"seldepth\":" << info.selDepth
+            << ",\"eval\":" << info.score
+            << ",\"bound\":\"" << (info.bound == ScoreBound::LOWER ? "lower" :
+                                   info.bound == ScoreBound::UPPER ? "upper" : "exact") << "\"";
+    }
+    out << ",\"nodes\":" << info.nodes
+        << ",\"nps\":" << info.nps
+        << ",\"timeMs\":" << info.timeMs;
+    if (!info.pv.empty()) {
+        out << ",\"pv\":[";
+        for (size_t i = 0; i < info.pv.size(); i++) {
+            if (i > 0) out << ",";
+            out << "\"" << info.pv[i].toString() << "\"";
+        }
+        out << "]";
+    }
+    out << "}";
+    return out.str();
+}
+
+} // namespace
+
+EnginePool::Options EngineService::poolOptions(const Options& options) {
+    EnginePool::Options pool;
+    pool.size = std::max(1, options.workers);
+    pool.depth = options.defaultDepth;
+    pool.ttSizeMB = options.ttSizeMB;
+    pool.sharedTT = options.sharedTT || !options.hashFile.empty();
+    return pool;
+}
+
+EngineService::EngineService(const Options& opts)
+    : options(opts), cache(opts.cacheEntries), pool(poolOptions(opts)) {
+    if (options.maxDepth > MAX_PLY - 1) options.maxDepth = MAX_PLY - 1;
+
+    // A missing snapshot is normal on the first start; the table starts empty
+    if (!options.hashFile.empty() && std::ifstream(options.hashFile).good()) {
+        if (pool.getSharedTT()->load(options.hashFile)) {
+            std::cout << "Loaded TT snapshot " << options.hashFile << std::endl;
+        }
+    }
+}
+
+bool EngineService::saveHash() {
+    if (options.hashFile.empty()) return false;
+    if (!pool.getSharedTT()->save(options.hashFile)) return false;
+    std::cout << "Saved TT snapshot " << options.hashFile << std::endl;
+    return true;
+}
+
+void EngineService::registerRoutes(HttpServer& server) {
+    server.route("GET", "/move", [this](const HttpRequest& request, int) {
+        return handleMove(request);
+    });
+    server.routeStream("GET", "/analyze", [this](const HttpRequest& request, HttpServer::ResponseStream& stream, int) {
+        handleAnalyze(request, stream);
+    });
+    server.routeStream("POST", "/batch", [this](const HttpRequest& request, HttpServer::ResponseStream& stream, int) {
+        handleBatch(request, stream);
+    });
+    server.routeInline("GET", "/status", [this, &server](const HttpRequest&) {
+        return handleStatus(server);
+    });
+}
+
+int EngineService::parseDepth(const std::string& value) const {
+    int depth = options.defaultDepth;
+    if (!value.empty()) {
+        try {
+            depth = std::stoi(value);
+        } catch (...) {
+            depth = options.defaultDepth;
+        }
+    }
+    return std::max(1, std::min(depth, options.maxDepth));
+}
+
+HttpResponse EngineService::handleMove(const HttpRequest& request) {
+    std::string fen = request.param("fen", START_FEN);
+    int depth = parseDepth(request.param("depth"));
+
+    // Validate and hash the position before taking an engine, so cache hits
+    // are answered even while every engine is busy
+    Board board;
+    board.setupFromFEN(fen);
+    std::string error;
+    if (!EnginePool::checkPosition(board, fen, error)) {
+        return jsonError(400, error);
+    }
+
+    CachedResult result;
+    if (!cache.lookup(board.getHashKey(), depth, result)) {
+        EnginePool::Lease lease = pool.acquire();
+        lease.setPosition(fen, error);
+
+        Engine& engine = lease.engine();
+        engine.setDepth(depth);
+        result = CachedResult::fromSearch(engine, engine.getBestMove());
+        cache.store(board.getHashKey(), result);
+    }
+
+    // No legal moves: checkmate or stalemate
+    if (result.move.isNull()) {
+        return HttpResponse(200, "{\"move\":null,\"eval\":0}");
+    }
+
+    std::ostringstream body;
+    body << "{\"move\":\"" << result.move.toString() << "\",\"eval\":" << result.eval << "}";
+    return HttpResponse(200, body.str());
+}
+
+void EngineService::handleAnalyze(const HttpRequest& request, HttpServer::ResponseStream& stream) {
+    std::string fen = request.param("fen", START_FEN);
+    int depth = parseDepth(request.param("depth"));
+    bool sse = request.param("format") != "json";
+
+    EnginePool::Lease lease = pool.acquire();
+
+    std::string error;
+    if (!lease.setPosition(fen, error)) {
+        stream.send(jsonError(400, error));
+        return;
+    }
+
+    stream.begin(200, sse ? "text/event-stream" : "application/x-ndjson", {{"Cache-Control", "no-cache"}});
+
+    // The listener runs on this thread, inside the search. A failed write
+    // means the client has gone, so there is nobody left to search for.
+    Engine& engine = lease.engine();
+    engine.setDepth(depth);
+    engine.setSearchListener([&](const SearchInfo& info) {
+        bool scored = info.iterationComplete || info.bound != ScoreBound::EXACT;
+        if (!stream.write(streamEvent(sse, scored ? "info" : "progress", searchInfoJson(info)))) {
+            engine.stop();
+        }
+    });
+
+    Move bestMove = engine.getBestMove();
+    cache.store(lease.game().getBoard().getHashKey(), CachedResult::fromSearch(engine, bestMove));
+
+    std::ostringstream result;
+    if (bestMove.isNull()) {
+        result << "{\"move\":null,\"eval\":0,\"depth\":0}";
+    } else {
+        result << "{\"move\":\"" << bestMove.toString() << "\",\"eval\":" << engine.getLastScore()
+               << ",\"depth\":" << engine.getLastDepth() << "}";
+    }
+    stream.write(streamEvent(sse, "bestmove", result.str()));
+}
+
+void EngineService::handleBatch(const HttpRequest& request, HttpServer::ResponseStream& stream) {
+    if (request.body.empty()) {
+        stream.send(jsonError(400, "Empty batch"));
+        return;
+    }
+
+    // Each batch searches a few positions at a time, so concurrent batches and
+    // /move requests take turns for engines instead of each batch claiming
+    // the whole pool
+    BatchAnalyzer::Options batchOptions;
+    batchOptions.defaultDepth = parseDepth(request.param("depth"));
+    batchOptions.maxDepth = options.maxDepth;
+    batchOptions.threads = std::max(1, std::min(options.batchThreads, pool.size()));
+    batchOptions.cache = &cache;
+    batchOptions.cancelled = [&stream]() { return stream.cancelled(); };
+    BatchAnalyzer analyzer(pool, batchOptions);
+
+    // Result lines go out as they come due; a failed write or a closed
+    // connection means the client has gone, and the analyzer then stops its searches
+    stream.begin(200, "application/x-ndjson", {{"Cache-Control", "no-cache"}});
+    std::istringstream input(request.body);
+    analyzer.run(input, [&stream](const std::string& line) {
+        return stream.write(line + "\n");
+    });
+}
+
+HttpResponse EngineService::handleStatus(const HttpServer& server) const {
+    std::ostringstream body;
+    body << "{\"status\":\"Engine Server Ready\""
+         << ",\"workers\":" << server.getWorkerCount()
+         << ",\"busyWorkers\":" << server.getBusyWorkers()
+         << ",\"queued\":" << server.getQueuedRequests()
+         << ",\"queueCapacity\":" << server.getQueueCapacity()
+         << ",\"connections\":" << server.getOpenConnections()
+         << ",\"served\":" << server.getRequestsServed()
+         << ",\"rejected\":" << server.getRequestsRejected()
+         << ",\"engines\":" << pool.size()
+         << ",\"idleEngines\":" << pool.available()
+         << ",\"cacheEntries\":" << cache.size()
+         << ",\"cacheHits\":" << cache.getHits()
+         << ",\"cacheMisses\":" << cache.getMisses()
+         << "}";
+    return HttpResponse(200, body.str());
+}
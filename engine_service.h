@@ -0,0 +1,62 @@
+#ifndef ENGINE_SERVICE_H
+#define ENGINE_SERVICE_H
+
+#include "engine_pool.h"
+#include "batch_analysis.h"
+#include "result_cache.h"
+#include "http_server.h"
+
+// HTTP endpoints backed by the engine. Engines come from an EnginePool that is
+// built at startup, so a request pays for its search and nothing else, and
+// searches running at the same time never share a Game or Engine. Finished
+// searches go into a result cache, and /move and /batch answer positions it
+// already holds to the requested depth without searching.
+//
+//   GET /move?fen=<fen>&depth=<n>  -> {"move":"e2e4","eval":35}
+//   GET /analyze?fen=<fen>&depth=<n>[&format=json]
+//                                  -> server-sent events while the search runs:
+//                                     "info" after every iteration or aspiration
+//                                     fail, "progress" in between, then "bestmove".
+//                                     format=json streams the same as JSON lines.
+//   POST /batch?depth=<n>          -> JSON lines in the body, one result line per
+//                                     position (see BatchAnalyzer for the format),
+//                                     streamed as each one is ready
+//   GET /status                    -> {"status":"...", queue, worker, pool and cache counters}
+class EngineService
+{
+public:
+    struct Options
+    {
+        int workers = 1;       // Pool size; one engine per server worker
+        int ttSizeMB = 16;     // Transposition table per engine (total with sharedTT)
+        bool sharedTT = false; // All engines probe and store into one table
+        int defaultDepth = 6;  // Used when the request has no depth
+        int maxDepth = 12;     // Requests are clamped to this depth
+        size_t cacheEntries = 65536; // Positions in the result cache (0 = off)
+        int batchThreads = 2;  // Positions one /batch request searches at once
+        std::string hashFile;  // TT snapshot loaded at startup and saved by saveHash (implies sharedTT)
+    };
+
+    explicit EngineService(const Options &options);
+
+    // Register the endpoints on the server (before HttpServer::start)
+    void registerRoutes(HttpServer &server);
+
+    HttpResponse handleMove(const HttpRequest &request);
+    void handleBatch(const HttpRequest &request, HttpServer::ResponseStream &stream);
+    void handleAnalyze(const HttpRequest &request, HttpServer::ResponseStream &stream);
+    HttpResponse handleStatus(const HttpServer &server) const;
+
+    // Save the shared TT to Options::hashFile; call once no requests are running
+    bool saveHash();
+
+private:
+    Options options;
+    ResultCache cache;
+    EnginePool pool;
+
+    static EnginePool::Options poolOptions(const Options &options);
+    int parseDepth(const std::string &value) const;
+};
+
+#endif // ENGINE_SERVICE_H
@@ -0,0 +1,827 @@
+#include "http_server.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+std::string toLower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return str;
+}
+
+std::string trim(const std::string& str) {
+    size_t start = str.find_first_not_of(" \t");
+    if (start == std::string::npos) return "";
+    size_t end = str.find_last_not_of(" \t");
+    return str.substr(start, end - start + 1);
+}
+
+const char* statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+HttpResponse errorResponse(int status, const std::string& message) {
+    return HttpResponse(status, "{\"error\":\"" + jsonEscape(message) + "\"}");
+}
+
+} // namespace
+
+std::string HttpRequest::param(const std::string& name, const std::string& fallback) const {
+    auto it = query.find(name);
+    return it != query.end() ? it->second : fallback;
+}
+
+std::string urlDecode(const std::string& str) {
+    std::string decoded;
+    decoded.reserve(str.length());
+    for (size_t i = 0; i < str.length(); i++) {
+        if (str[i] == '%' && i + 2 < str.length() &&
+            std::isxdigit(static_cast<unsigned char>(str[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(str[i + 2]))) {
+            decoded += static_cast<char>(std::stoi(str.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else if (str[i] == '+') {
+            decoded += ' ';
+        } else {
+            decoded += str[i];
+        }
+    }
+    return decoded;
+}
+
+std::string jsonEscape(const std::string& str) {
+    std::string escaped;
+    escaped.reserve(str.length());
+    for (char c : str) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    escaped += buffer;
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+// Readiness notification: epoll where available, plain poll() otherwise
+class HttpServer::Poller {
+public:
+    struct Event {
+        int fd;
+        bool readable;
+        bool writable;
+        bool error;
+    };
+
+#ifdef __linux__
+    Poller() : epollFd(epoll_create1(0)) {}
+    ~Poller() { if (epollFd >= 0) close(epollFd); }
+
+    bool valid() const { return epollFd >= 0; }
+
+    void add(int fd) { control(EPOLL_CTL_ADD, fd, false); }
+    void setWrite(int fd, bool wantWrite) { control(EPOLL_CTL_MOD, fd, wantWrite); }
+    void remove(int fd) { epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr); }
+
+    void wait(int timeoutMs, std::vector<Event>& out) {
+        epoll_event events[128];
+        int count = epoll_wait(epollFd, events, 128, timeoutMs);
+        out.clear();
+        for (int i = 0; i < count; i++) {
+            out.push_back({events[i].data.fd,
+                           (events[i].events & EPOLLIN) != 0,
+                           (events[i].events & EPOLLOUT) != 0,
+                           (events[i].events & (EPOLLERR | EPOLLHUP)) != 0});
+        }
+    }
+
+private:
+    int epollFd;
+
+    void control(int op, int fd, bool wantWrite) {
+        epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN | EPOLLRDHUP | (wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        event.data.fd = fd;
+        epoll_ctl(epollFd, op, fd, &event);
+    }
+#else
+    bool valid() const { return true; }
+
+    void add(int fd) { interest[fd] = POLLIN; }
+    void setWrite(int fd, bool wantWrite) { interest[fd] = POLLIN | (wantWrite ? POLLOUT : 0); }
+    void remove(int fd) { interest.erase(fd); }
+
+    void wait(int timeoutMs, std::vector<Event>& out) {
+        std::vector<pollfd> fds;
+        fds.reserve(interest.size());
+        for (const auto& entry : interest) {
+            fds.push_back({entry.first, entry.second, 0});
+        }
+        int count = poll(fds.data(), fds.size(), timeoutMs);
+        out.clear();
+        for (int i = 0; count > 0 && i < static_cast<int>(fds.size()); i++) {
+            if (fds[i].revents == 0) continue;
+            out.push_back({fds[i].fd,
+                           (fds[i].revents & POLLIN) != 0,
+                           (fds[i].revents & POLLOUT) != 0,
+                           (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) != 0});
+        }
+    }
+
+private:
+    std::map<int, short> interest;
+#endif
+};
+
+HttpServer::HttpServer(const Config& cfg)
+    : config(cfg),
+      listenFd(-1),
+      running(false),
+      nextConnectionId(1),
+      busyWorkers(0),
+      openConnections(0),
+      requestsServed(0),
+      requestsRejected(0) {
+    wakePipe[0] = wakePipe[1] = -1;
+    if (config.workers < 1) config.workers = 1;
+    if (config.queueCapacity < 1) config.queueCapacity = 1;
+}
+
+HttpServer::~HttpServer() {
+    stop();
+
+    // Release the workers; anything still queued is dropped
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.clear();
+    }
+    jobAvailable.notify_all();
+    for (auto& thread : workerThreads) {
+        if (thread.joinable()) thread.join();
+    }
+
+    for (auto& entry : connections) {
+        close(entry.first);
+    }
+    if (listenFd >= 0) close(listenFd);
+    if (wakePipe[0] >= 0) close(wakePipe[0]);
+    if (wakePipe[1] >= 0) close(wakePipe[1]);
+}
+
+void HttpServer::route(const std::string& method, const std::string& path, WorkerHandler handler) {
+    routes[{method, path}].worker = std::move(handler);
+}
+
+void HttpServer::routeInline(const std::string& method, const std::string& path, InlineHandler handler) {
+    routes[{method, path}].inlineHandler = std::move(handler);
+}
+
+void HttpServer::routeStream(const std::string& method, const std::string& path, StreamHandler handler) {
+    routes[{method, path}].stream = std::move(handler);
+}
+
+bool HttpServer::start() {
+    poller.reset(new Poller());
+    if (!poller->valid()) {
+        std::cerr << "Error: cannot create event poller: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (pipe(wakePipe) != 0 || !setNonBlocking(wakePipe[0]) || !setNonBlocking(wakePipe[1])) {
+        std::cerr << "Error: cannot create wake-up pipe: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "Error: socket creation failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    int yes = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(config.port));
+
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Error: bind to port " << config.port << " failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (listen(listenFd, SOMAXCONN) != 0 || !setNonBlocking(listenFd)) {
+        std::cerr << "Error: listen failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    poller->add(listenFd);
+    poller->add(wakePipe[0]);
+
+    running = true;
+    for (int i = 0; i < config.workers; i++) {
+        workerThreads.emplace_back(&HttpServer::workerLoop, this, i);
+    }
+    return true;
+}
+
+void HttpServer::stop() {
+    running = false;
+    wake();
+}
+
+void HttpServer::wake() {
+    if (wakePipe[1] >= 0) {
+        char byte = 1;
+        ssize_t ignored = write(wakePipe[1], &byte, 1);
+        (void)ignored;
+    }
+}
+
+size_t HttpServer::getQueuedRequests() const {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    return jobs.size();
+}
+
+void HttpServer::run() {
+    std::vector<Poller::Event> events;
+    auto lastSweep = std::chrono::steady_clock::now();
+
+    while (running) {
+        poller->wait(1000, events);
+
+        for (const auto& event : events) {
+            if (event.fd == listenFd) {
+                acceptConnections();
+                continue;
+            }
+            if (event.fd == wakePipe[0]) {
+                char buffer[256];
+                while (read(wakePipe[0], buffer, sizeof(buffer)) > 0) {}
+                continue;
+            }
+
+            auto it = connections.find(event.fd);
+            if (it == connections.end() || it->second->closed) continue;
+            Connection& conn = *it->second;
+
+            if (event.readable || event.error) {
+                readFrom(conn);
+            }
+            if (event.writable && !conn.closed) {
+                flush(conn);
+            }
+        }
+
+        drainCompletions();
+        reapClosedConnections();
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSweep >= std::chrono::seconds(1)) {
+            closeIdleConnections();
+            lastSweep = now;
+        }
+    }
+
+    // Let running stream handlers see the shutdown, then wake the workers so they can exit
+    for (auto& entry : connections) {
+        if (entry.second->cancelFlag) entry.second->cancelFlag->store(true);
+    }
+    jobAvailable.notify_all();
+}
+
+void HttpServer::workerLoop(int index) {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobAvailable.wait(lock, [this] { return !jobs.empty() || !running; });
+            if (!running) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        busyWorkers++;
+        if (job.streamHandler) {
+            ResponseStream stream(*this, job.connectionId, job.request, job.cancelFlag);
+            try {
+                job.streamHandler(job.request, stream, index);
+            } catch (const std::exception& e) {
+                stream.send(errorResponse(500, e.what()));
+            } catch (...) {
+                stream.send(errorResponse(500, "Internal error"));
+            }
+            stream.finish();
+            busyWorkers--;
+            continue;
+        }
+
+        HttpResponse response;
+        try {
+            response = job.handler(job.request, index);
+        } catch (const std::exception& e) {
+            response = errorResponse(500, e.what());
+        } catch (...) {
+            response = errorResponse(500, "Internal error");
+        }
+        busyWorkers--;
+
+        Completion completion;
+        completion.connectionId = job.connectionId;
+        completion.response = std::move(response);
+        completion.keepAlive = job.request.keepAlive;
+        post(std::move(completion));
+    }
+}
+
+void HttpServer::post(Completion completion) {
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        completions.push_back(std::move(completion));
+    }
+    wake();
+}
+
+HttpServer::ResponseStream::ResponseStream(HttpServer& owner, uint64_t id, const HttpRequest& request,
+                                           std::shared_ptr<std::atomic<bool>> flag)
+    : server(owner),
+      connectionId(id),
+      keepAlive(request.keepAlive),
+      chunked(request.version != "HTTP/1.0"),
+      cancelFlag(std::move(flag)) {}
+
+void HttpServer::ResponseStream::send(const HttpResponse& response) {
+    if (started || done) return;
+    done = true;
+
+    Completion completion;
+    completion.connectionId = connectionId;
+    completion.response = response;
+    completion.keepAlive = keepAlive;
+    server.post(std::move(completion));
+}
+
+void HttpServer::ResponseStream::begin(int status, const std::string& contentType,
+                                       const std::vector<std::pair<std::string, std::string>>& headers) {
+    if (started || done) return;
+    started = true;
+
+    // Without chunked encoding the only way to end the body is to close the connection
+    if (!chunked) keepAlive = false;
+
+    Completion completion;
+    completion.connectionId = connectionId;
+    completion.keepAlive = keepAlive;
+    completion.streamed = true;
+    completion.data = serializeHead(status, contentType, headers, keepAlive, chunked);
+    completion.last = false;
+    server.post(std::move(completion));
+}
+
+bool HttpServer::ResponseStream::write(const std::string& data) {
+    if (!started || done || cancelled()) return false;
+    if (data.empty()) return true; // An empty chunk would end the body
+
+    Completion completion;
+    completion.connectionId = connectionId;
+    completion.keepAlive = keepAlive;
+    completion.streamed = true;
+    completion.last = false;
+    if (chunked) {
+        char size[24];
+        snprintf(size, sizeof(size), "%zx\r\n", data.size());
+        completion.data = size + data + "\r\n";
+    } else {
+        completion.data = data;
+    }
+    server.post(std::move(completion));
+    return true;
+}
+
+void HttpServer::ResponseStream::finish() {
+    if (done) return;
+    if (!started) {
+        send(errorResponse(500, "No response"));
+        return;
+    }
+    done = true;
+
+    Completion completion;
+    completion.connectionId = connectionId;
+    completion.keepAlive = keepAlive;
+    completion.streamed = true;
+    completion.data = chunked ? "0\r\n\r\n" : "";
+    completion.last = true;
+    server.post(std::move(completion));
+}
+
+void HttpServer::acceptConnections() {
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            // EAGAIN: nothing left to accept; anything else (e.g. EMFILE) is retried on the next event
+            return;
+        }
+        if (!setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+        std::unique_ptr<Connection> conn(new Connection());
+        conn->fd = fd;
+        conn->id = nextConnectionId++;
+        conn->lastActivity = std::chrono::steady_clock::now();
+
+        connectionFds[conn->id] = fd;
+        connections[fd] = std::move(conn);
+        poller->add(fd);
+        openConnections++;
+    }
+}
+
+void HttpServer::readFrom(Connection& conn) {
+    char buffer[16 * 1024];
+    while (true) {
+        ssize_t received = recv(conn.fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            conn.input.append(buffer, static_cast<size_t>(received));
+            conn.lastActivity = std::chrono::steady_clock::now();
+            // processInput only checks the limits between requests; while a
+            // worker has this connection, a client streaming more than one
+            // maximal request could otherwise grow the buffer without bound
+            if (conn.input.size() > config.maxHeaderBytes + 4 + config.maxBodyBytes) {
+                closeConnection(conn);
+                return;
+            }
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        // Peer closed or error; a pending worker response is simply dropped
+        closeConnection(conn);
+        return;
+    }
+
+    processInput(conn);
+}
+
+void HttpServer::processInput(Connection& conn) {
+    // One request at a time per connection keeps pipelined responses in order
+    while (!conn.busy && !conn.closeAfterWrite && !conn.closed) {
+        size_t headEnd = conn.input.find("\r\n\r\n");
+        if (headEnd == std::string::npos) {
+            if (conn.input.size() > config.maxHeaderBytes) {
+                respond(conn, errorResponse(431, "Request header too large"), false);
+            }
+            return;
+        }
+        if (headEnd > config.maxHeaderBytes) {
+            respond(conn, errorResponse(431, "Request header too large"), false);
+            return;
+        }
+
+        HttpRequest request;
+        if (!parseHead(conn.input.substr(0, headEnd), request)) {
+            respond(conn, errorResponse(400, "Malformed request"), false);
+            return;
+        }
+
+        if (request.headers.count("transfer-encoding")) {
+            respond(conn, errorResponse(501, "Chunked request bodies are not supported"), false);
+            return;
+        }
+
+        size_t bodyLength = 0;
+        auto lengthHeader = request.headers.find("content-length");
+        if (lengthHeader != request.headers.end()) {
+            try {
+                bodyLength = std::stoul(lengthHeader->second);
+            } catch (...) {
+                respond(conn, errorResponse(400, "Invalid Content-Length"), false);
+                return;
+            }
+            if (bodyLength > config.maxBodyBytes) {
+                respond(conn, errorResponse(413, "Request body too large"), false);
+                return;
+            }
+        }
+
+        size_t total = headEnd + 4 + bodyLength;
+        if (conn.input.size() < total) {
+            return; // Wait for the rest of the body
+        }
+        request.body = conn.input.substr(headEnd + 4, bodyLength);
+        conn.input.erase(0, total);
+
+        dispatch(conn, request);
+    }
+}
+
+void HttpServer::dispatch(Connection& conn, HttpRequest& request) {
+    // CORS preflight for browser clients
+    if (request.method == "OPTIONS") {
+        HttpResponse response(204, "");
+        response.headers.push_back({"Access-Control-Allow-Methods", "GET, POST, OPTIONS"});
+        response.headers.push_back({"Access-Control-Allow-Headers", "Content-Type"});
+        respond(conn, response, request.keepAlive);
+        return;
+    }
+
+    auto it = routes.find({request.method, request.path});
+    if (it == routes.end()) {
+        bool pathExists = false;
+        for (const auto& entry : routes) {
+            if (entry.first.second == request.path) pathExists = true;
+        }
+        respond(conn, pathExists ? errorResponse(405, "Method not allowed") : errorResponse(404, "Unknown request"),
+                request.keepAlive);
+        return;
+    }
+
+    const Route& route = it->second;
+    if (route.inlineHandler) {
+        HttpResponse response;
+        try {
+            response = route.inlineHandler(request);
+        } catch (const std::exception& e) {
+            response = errorResponse(500, e.what());
+        }
+        respond(conn, response, request.keepAlive);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        if (jobs.size() >= config.queueCapacity) {
+            requestsRejected++;
+            HttpResponse response = errorResponse(503, "Server busy, retry later");
+            response.headers.push_back({"Retry-After", "1"});
+            respond(conn, response, request.keepAlive);
+            return;
+        }
+        conn.busy = true;
+        if (route.stream) {
+            conn.cancelFlag = std::make_shared<std::atomic<bool>>(false);
+            jobs.push_back({conn.id, std::move(request), nullptr, route.stream, conn.cancelFlag});
+        } else {
+            jobs.push_back({conn.id, std::move(request), route.worker, nullptr, nullptr});
+        }
+    }
+    jobAvailable.notify_one();
+}
+
+void HttpServer::respond(Connection& conn, const HttpResponse& response, bool keepAlive) {
+    requestsServed++;
+    conn.output += serialize(response, keepAlive);
+    if (!keepAlive) {
+        conn.closeAfterWrite = true;
+    }
+    flush(conn);
+}
+
+void HttpServer::flush(Connection& conn) {
+    while (!conn.output.empty()) {
+        ssize_t sent = send(conn.fd, conn.output.data(), conn.output.size(), MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn.output.erase(0, static_cast<size_t>(sent));
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!conn.wantWrite) {
+                conn.wantWrite = true;
+                poller->setWrite(conn.fd, true);
+            }
+            return;
+        }
+        closeConnection(conn);
+        return;
+    }
+
+    if (conn.wantWrite) {
+        conn.wantWrite = false;
+        poller->setWrite(conn.fd, false);
+    }
+
+    if (conn.closeAfterWrite) {
+        closeConnection(conn);
+    }
+}
+
+// The socket stays open until the connection is freed so its descriptor
+// cannot be reused by a new connection while the old entry is still mapped
+void HttpServer::closeConnection(Connection& conn) {
+    if (conn.closed) return;
+
+    conn.closed = true;
+    if (conn.cancelFlag) conn.cancelFlag->store(true);
+    poller->remove(conn.fd);
+    connectionFds.erase(conn.id);
+    closedConnections.push_back(conn.fd);
+    openConnections--;
+}
+
+void HttpServer::reapClosedConnections() {
+    for (int fd : closedConnections) {
+        close(fd);
+        connections.erase(fd);
+    }
+    closedConnections.clear();
+}
+
+void HttpServer::drainCompletions() {
+    std::vector<Completion> done;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        done.swap(completions);
+    }
+
+    for (auto& completion : done) {
+        auto idIt = connectionFds.find(completion.connectionId);
+        if (idIt == connectionFds.end()) continue; // Client went away
+
+        Connection& conn = *connections[idIt->second];
+        conn.lastActivity = std::chrono::steady_clock::now();
+
+        if (completion.streamed) {
+            conn.output += completion.data;
+            if (!completion.last) {
+                flush(conn);
+                continue;
+            }
+            conn.busy = false;
+            conn.cancelFlag.reset();
+            requestsServed++;
+            if (!completion.keepAlive) {
+                conn.closeAfterWrite = true;
+            }
+            flush(conn);
+            processInput(conn);
+            continue;
+        }
+
+        conn.busy = false;
+        conn.cancelFlag.reset();
+        respond(conn, completion.response, completion.keepAlive);
+
+        // Pick up the next pipelined request, if one is already buffered
+        processInput(conn);
+    }
+}
+
+void HttpServer::closeIdleConnections() {
+    auto now = std::chrono::steady_clock::now();
+    auto timeout = std::chrono::seconds(config.idleTimeoutSeconds);
+
+    for (auto& entry : connections) {
+        Connection& conn = *entry.second;
+        if (!conn.busy && conn.output.empty() && now - conn.lastActivity > timeout) {
+            closeConnection(conn);
+        }
+    }
+}
+
+bool HttpServer::parseHead(const std::string& head, HttpRequest& request) {
+    std::istringstream stream(head);
+    std::string requestLine;
+    if (!std::getline(stream, requestLine)) return false;
+    if (!requestLine.empty() && requestLine.back() == '\r') requestLine.pop_back();
+
+    std::istringstream line(requestLine);
+    std::string target;
+    if (!(line >> request.method >> target >> request.version)) return false;
+    if (request.version.compare(0, 5, "HTTP/") != 0) return false;
+
+    // Split the target into path and query parameters
+    size_t queryStart = target.find('?');
+    request.path = target.substr(0, queryStart);
+    if (queryStart != std::string::npos) {
+        std::string queryString = target.substr(queryStart + 1);
+        size_t pos = 0;
+        while (pos <= queryString.length()) {
+            size_t end = queryString.find('&', pos);
+            if (end == std::string::npos) end = queryString.length();
+            std::string pair = queryString.substr(pos, end - pos);
+            if (!pair.empty()) {
+                size_t eq = pair.find('=');
+                if (eq == std::string::npos) {
+                    request.query[urlDecode(pair)] = "";
+                } else {
+                    request.query[urlDecode(pair.substr(0, eq))] = urlDecode(pair.substr(eq + 1));
+                }
+            }
+            pos = end + 1;
+        }
+    }
+
+    std::string headerLine;
+    while (std::getline(stream, headerLine)) {
+        if (!headerLine.empty() && headerLine.back() == '\r') headerLine.pop_back();
+        if (headerLine.empty()) continue;
+        size_t colon = headerLine.find(':');
+        if (colon == std::string::npos) return false;
+        request.headers[toLower(trim(headerLine.substr(0, colon)))] = trim(headerLine.substr(colon + 1));
+    }
+
+    // HTTP/1.1 keeps connections open unless told otherwise; 1.0 closes them
+    auto connection = request.headers.find("connection");
+    std::string connectionValue = connection != request.headers.end() ? toLower(connection->second) : "";
+    if (request.version == "HTTP/1.0") {
+        request.keepAlive = connectionValue == "keep-alive";
+    } else {
+        request.keepAlive = connectionValue != "close";
+    }
+    return true;
+}
+
+std::string HttpServer::serialize(const HttpResponse& response, bool keepAlive) {
+    std::ostringstream out;
+    out << "HTTP/1.1 " << response.status << " " << statusText(response.status) << "\r\n";
+    if (response.status != 204) {
+        out << "Content-Type: " << response.contentType << "\r\n";
+        out << "Content-Length: " << response.body.length() << "\r\n";
+    }
+    out << "Access-Control-Allow-Origin: *\r\n";
+    out << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n";
+    for (const auto& header : response.headers) {
+        out << header.first << ": " << header.second << "\r\n";
+    }
+    out << "\r\n";
+    if (response.status != 204) {
+        out << response.body;
+    }
+    return out.str();
+}
+
+std::string HttpServer::serializeHead(int status, const std::string& contentType,
+                                      const std::vector<std::pair<std::string, std::string>>& headers,
+                                      bool keepAlive, bool chunked) {
+    std::ostringstream out;
+    out << "HTTP/1.1 " << status << " " << statusText(status) << "\r\n";
+    out << "Content-Type: " << contentType << "\r\n";
+    if (chunked) {
+        out << "Transfer-Encoding: chunked\r\n";
+    }
+    out << "Access-Control-Allow-Origin: *\r\n";
+    out << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n";
+    for (const auto& header : headers) {
+        out << header.first << ": " << header.second << "\r\n";
+    }
+    out << "\r\n";
+    return out.str();
+}
@@ -0,0 +1,236 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+// A parsed HTTP/1.x request
+struct HttpRequest
+{
+    std::string method;                          // "GET", "POST", ...
+    std::string path;                            // Path without the query string
+    std::string version;                         // "HTTP/1.1"
+    std::map<std::string, std::string> query;    // Decoded query parameters
+    std::map<std::string, std::string> headers;  // Header names are lower-cased
+    std::string body;
+    bool keepAlive = true;
+
+    // Query parameter, or fallback if it is absent
+    std::string param(const std::string &name, const std::string &fallback = "") const;
+};
+
+struct HttpResponse
+{
+    int status = 200;
+    std::string contentType = "application/json";
+    std::string body;
+    std::vector<std::pair<std::string, std::string>> headers; // Extra headers
+
+    HttpResponse() {}
+    HttpResponse(int s, std::string b, std::string type = "application/json")
+        : status(s), contentType(std::move(type)), body(std::move(b)) {}
+};
+
+// Decode %XX escapes and '+' in a URL component
+std::string urlDecode(const std::string &str);
+
+// Escape a string for use inside a JSON string literal
+std::string jsonEscape(const std::string &str);
+
+// Small HTTP/1.1 server: one thread runs a non-blocking event loop (epoll on
+// Linux, poll() elsewhere) that accepts connections and frames requests, and a
+// pool of worker threads runs the slow handlers. Requests for worker routes go
+// through a bounded queue; when it is full the server answers 503 right away
+// instead of letting the backlog grow. Connections are kept alive, and
+// pipelined requests on one connection are answered in order. Stream routes
+// send their response in pieces as it is produced (chunked transfer encoding),
+// for server-sent events and other live updates.
+class HttpServer
+{
+public:
+    struct Config
+    {
+        int port = 8080;
+        int workers = 1;                     // Worker threads for worker routes
+        size_t queueCapacity = 64;           // Queued requests before answering 503
+        size_t maxHeaderBytes = 16 * 1024;   // Request line plus headers
+        size_t maxBodyBytes = 1024 * 1024;   // Content-Length limit
+        int idleTimeoutSeconds = 30;         // Idle keep-alive connections are closed
+    };
+
+    // Runs on a worker thread; workerIndex is in [0, workers)
+    typedef std::function<HttpResponse(const HttpRequest &, int workerIndex)> WorkerHandler;
+
+    // Runs on the event loop thread, so it must return quickly
+    typedef std::function<HttpResponse(const HttpRequest &)> InlineHandler;
+
+    // Handed to a stream handler to send its response piece by piece. Each
+    // piece goes out as an HTTP/1.1 chunk (HTTP/1.0 clients get a plain body
+    // ended by closing the connection). Only used from the handler's thread.
+    class ResponseStream
+    {
+    public:
+        // Answer with an ordinary response instead (e.g. an error); only before begin()
+        void send(const HttpResponse &response);
+
+        // Send the status line and headers; the body follows through write()
+        void begin(int status, const std::string &contentType,
+                   const std::vector<std::pair<std::string, std::string>> &headers = {});
+
+        // Send the next piece of the body; false once the client has gone away
+        bool write(const std::string &data);
+
+        // The client disconnected or the server is shutting down
+        bool cancelled() const { return cancelFlag->load(); }
+
+    private:
+        friend class HttpServer;
+        ResponseStream(HttpServer &server, uint64_t connectionId, const HttpRequest &request,
+                       std::shared_ptr<std::atomic<bool>> cancelFlag);
+
+        // End the response after the handler returns
+        void finish();
+
+        HttpServer &server;
+        uint64_t connectionId;
+        bool keepAlive;
+        bool chunked;
+        bool started = false;
+        bool done = false;
+        std::shared_ptr<std::atomic<bool>> cancelFlag;
+    };
+
+    // Runs on a worker thread and writes its response through the stream
+    typedef std::function<void(const HttpRequest &, ResponseStream &, int workerIndex)> StreamHandler;
+
+    explicit HttpServer(const Config &config);
+    ~HttpServer();
+
+    // Register a handler for method + exact path. Call before start().
+    void route(const std::string &method, const std::string &path, WorkerHandler handler);
+    void routeInline(const std::string &method, const std::string &path, InlineHandler handler);
+    void routeStream(const std::string &method, const std::string &path, StreamHandler handler);
+
+    // Bind, listen and start the workers; false (with a message on std::cerr) on failure
+    bool start();
+
+    // Run the event loop until stop() is called
+    void run();
+
+    // Stop the event loop; safe to call from other threads and signal handlers
+    void stop();
+
+    // Counters for status pages
+    int getWorkerCount() const { return config.workers; }
+    int getBusyWorkers() const { return busyWorkers.load(); }
+    size_t getQueuedRequests() const;
+    size_t getQueueCapacity() const { return config.queueCapacity; }
+    int getOpenConnections() const { return openConnections.load(); }
+    long getRequestsServed() const { return requestsServed.load(); }
+    long getRequestsRejected() const { return requestsRejected.load(); }
+
+private:
+    struct Route
+    {
+        WorkerHandler worker;
+        InlineHandler inlineHandler;
+        StreamHandler stream;
+    };
+
+    struct Connection
+    {
+        int fd;
+        uint64_t id;
+        std::string input;
+        std::string output;
+        bool busy = false;            // A request is with a worker
+        bool closeAfterWrite = false;
+        bool wantWrite = false;
+        bool closed = false;          // Closed; freed at the end of the loop iteration
+        std::shared_ptr<std::atomic<bool>> cancelFlag; // Set on close while a stream is running
+        std::chrono::steady_clock::time_point lastActivity;
+    };
+
+    struct Job
+    {
+        uint64_t connectionId;
+        HttpRequest request;
+        WorkerHandler handler;
+        StreamHandler streamHandler;
+        std::shared_ptr<std::atomic<bool>> cancelFlag;
+    };
+
+    struct Completion
+    {
+        uint64_t connectionId;
+        HttpResponse response;
+        bool keepAlive;
+        bool streamed = false; // data holds raw bytes of a streamed response
+        std::string data;
+        bool last = true;      // The request is finished
+    };
+
+    class Poller;
+
+    Config config;
+    std::map<std::pair<std::string, std::string>, Route> routes; // (method, path)
+
+    int listenFd;
+    int wakePipe[2];
+    std::unique_ptr<Poller> poller;
+    std::atomic<bool> running;
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections; // by fd
+    std::unordered_map<uint64_t, int> connectionFds;                 // id -> fd
+    std::vector<int> closedConnections;                              // Waiting to be freed
+    uint64_t nextConnectionId;
+
+    // Job queue (event loop -> workers)
+    mutable std::mutex jobMutex;
+    std::condition_variable jobAvailable;
+    std::deque<Job> jobs;
+    std::vector<std::thread> workerThreads;
+
+    // Finished responses (workers -> event loop)
+    std::mutex completionMutex;
+    std::vector<Completion> completions;
+
+    std::atomic<int> busyWorkers;
+    std::atomic<int> openConnections;
+    std::atomic<long> requestsServed;
+    std::atomic<long> requestsRejected;
+
+    void workerLoop(int index);
+    void wake();
+    void post(Completion completion);
+
+    void acceptConnections();
+    void readFrom(Connection &conn);
+    void processInput(Connection &conn);
+    void dispatch(Connection &conn, HttpRequest &request);
+    void respond(Connection &conn, const HttpResponse &response, bool keepAlive);
+    void flush(Connection &conn);
+    void closeConnection(Connection &conn);
+    void reapClosedConnections();
+    void drainCompletions();
+    void closeIdleConnections();
+
+    // Parse the head of a request; false if it is malformed
+    static bool parseHead(const std::string &head, HttpRequest &request);
+    static std::string serialize(const HttpResponse &response, bool keepAlive);
+    static std::string serializeHead(int status, const std::string &contentType,
+                                     const std::vector<std::pair<std::string, std::string>> &headers,
+                                     bool keepAlive, bool chunked);
+};
+
+#endif // HTTP_SERVER_H
@@ -1,8 +1,205 @@
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
 #include "game.h"
 #include "engine.h"
+#include "engine_pool.h"
+#include "batch_analysis.h"
+#include "transposition.h"
+
+// chess_engine --batch <in.jsonl|-> [--out <out.jsonl>] [--threads N] [--depth N]
+//              [--max-depth N] [--nodes N] [--hash MB] [--shared-tt] [--cache N]
+//              [--hash-file PATH]
+static int runBatch(int argc, char* argv[]) {
+    std::string inputPath;
+    std::string outputPath = "-";
+    EnginePool::Options poolOptions;
+    BatchAnalyzer::Options batchOptions;
+    size_t cacheEntries = 0;
+    std::string hashFile;
+    poolOptions.size = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--shared-tt") {
+            poolOptions.sharedTT = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: missing value for " << arg << std::endl;
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--batch") inputPath = value;
+        else if (arg == "--out") outputPath = value;
+        else if (arg == "--threads") poolOptions.size = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--depth") batchOptions.defaultDepth = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--max-depth") batchOptions.maxDepth = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--nodes") batchOptions.defaultNodes = std::max(0L, std::atol(value.c_str()));
+        else if (arg == "--hash") poolOptions.ttSizeMB = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--hash-file") hashFile = value;
+        else if (arg == "--cache") cacheEntries = static_cast<size_t>(std::max(0, std::atoi(value.c_str())));
+        else {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if (poolOptions.size == 0) {
+        unsigned cores = std::thread::hardware_concurrency();
+        poolOptions.size = cores > 0 ? static_cast<int>(cores) : 1;
+    }
+    poolOptions.depth = batchOptions.defaultDepth;
+    // A snapshot is one table, so it needs the engines to share theirs
+    if (!hashFile.empty()) poolOptions.sharedTT = true;
+
+    std::ifstream inputFile;
+    if (inputPath != "-") {
+        inputFile.open(inputPath);
+        if (!inputFile) {
+            std::cerr << "Error: cannot open " << inputPath << std::endl;
+            return 1;
+        }
+    }
+    std::ofstream outputFile;
+    if (outputPath != "-") {
+        outputFile.open(outputPath);
+        if (!outputFile) {
+            std::cerr << "Error: cannot write " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    std::istream& input = inputPath == "-" ? std::cin : inputFile;
+    std::ostream& output = outputPath == "-" ? std::cout : outputFile;
+
+    // The engines announce themselves on stdout while they start; keep that
+    // out of the results when they go to stdout too
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+    EnginePool pool(poolOptions);
+    std::cout.rdbuf(stdoutBuffer);
+
+    // Start from an earlier run's table when there is one
+    if (!hashFile.empty() && std::ifstream(hashFile).good()) {
+        pool.getSharedTT()->load(hashFile);
+    }
+
+    // Only pays off when the input repeats positions, so it is off unless asked for
+    ResultCache cache(cacheEntries);
+    batchOptions.cache = &cache;
+
+    BatchAnalyzer analyzer(pool, batchOptions);
+    auto start = std::chrono::steady_clock::now();
+    size_t count = analyzer.run(input, output);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << "Analyzed " << count << " positions in " << elapsed << "ms on "
+              << pool.size() << " engines" << std::endl;
+
+    if (!hashFile.empty() && !pool.getSharedTT()->save(hashFile)) {
+        return 1;
+    }
+    return 0;
+}
+
+// chess_engine --tt-bench [MB ...]
+// Allocates and clears a transposition table of each size and reports how it
+// is backed, how long that took and how long a probe's memory access takes
+static int runTTBench(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 2; i < argc; i++) {
+        int sizeMB = std::atoi(argv[i]);
+        if (sizeMB < 1) {
+            std::cerr << "Error: invalid table size " << argv[i] << std::endl;
+            return 1;
+        }
+        sizes.push_back(sizeMB);
+    }
+    if (sizes.empty()) sizes = {16, 256, 1024};
+
+    for (int sizeMB : sizes) {
+        TranspositionTable table(sizeMB);
+        std::cout << table.describe() << ", probe " << table.measureProbeLatencyNs() << " ns" << std::endl;
+    }
+    return 0;
+}
+
+// chess_engine --search-bench [--depth N] [MB ...]
+// Searches a fixed set of positions with each hash size, once without and once
+// with child prefetching, and reports the nodes per second of each run
+static int runSearchBench(int argc, char* argv[]) {
+    static const char* BENCH_FENS[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r1bq1rk1/pp2bppp/2n2n2/3p4/3P4/2NBPN2/PP3PPP/R2QK2R w KQ - 0 9",
+    };
+    int depth = 9;
+    std::vector<int> sizes;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc) {
+            depth = std::max(1, std::atoi(argv[++i]));
+        } else if (std::atoi(arg.c_str()) >= 1) {
+            sizes.push_back(std::atoi(arg.c_str()));
+        } else {
+            std::cerr << "Error: invalid argument " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (sizes.empty()) sizes = {16, 1024};
+
+    // Keep the engine's own output out of the report
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+    Game game;
+    Engine engine(game, depth, sizes.front());
+
+    for (int sizeMB : sizes) {
+        if (!engine.setTTSize(sizeMB)) {
+            continue;
+        }
+        for (int prefetch = 0; prefetch < 2; prefetch++) {
+            engine.setPrefetch(prefetch == 1);
+            long nodes = 0;
+            double seconds = 0;
+            for (const char* fen : BENCH_FENS) {
+                game.newGameFromFEN(fen);
+                engine.clearTT();
+                engine.resetHeuristics();
+                engine.setDepth(depth);
+                auto start = std::chrono::steady_clock::now();
+                engine.getBestMove();
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                nodes += engine.getNodesSearched();
+            }
+            std::cout.rdbuf(stdoutBuffer);
+            std::cout << sizeMB << " MB, prefetch " << (prefetch ? "on " : "off") << ": " << nodes
+                      << " nodes in " << static_cast<long>(seconds * 1000) << " ms, "
+                      << static_cast<long>(nodes / std::max(seconds, 0.001)) << " nps" << std::endl;
+            std::cout.rdbuf(std::cerr.rdbuf());
+        }
+    }
+    std::cout.rdbuf(stdoutBuffer);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--tt-bench") {
+        return runTTBench(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--search-bench") {
+        return runSearchBench(argc, argv);
+    }
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--batch") {
+            return runBatch(argc, argv);
+        }
+    }
 
-int main() {
     try {
         std::cout << "Creating Game..." << std::endl;
         Game game;
@@ -15,4 +212,4 @@ int main() {
         std::cin.get();
     }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,175 @@
+#include "move_picker.h"
+#include "engine.h"
+
+// Puts capturing evasions above every quiet one, whatever the history says
+static const int EVASION_CAPTURE_BONUS = 1 << 24;
+
+MovePicker::MovePicker(const Engine& engine, const Board& board, const Move& hashMove, int ply, const Move& lastMove)
+    : engine(engine), board(board), hashMove(hashMove), ply(ply), lastMove(lastMove), stage(Stage::HASH_MOVE),
+      quiescence(false), inCheck(board.isInCheck()), captureIndex(0), badCaptureCount(0), badCaptureIndex(0),
+      refutationCount(0), refutationIndex(0), quietIndex(0) {}
+
+MovePicker::MovePicker(const Engine& engine, const Board& board, const Move& hashMove)
+    : engine(engine), board(board), hashMove(hashMove), ply(0), lastMove(), stage(Stage::HASH_MOVE),
+      quiescence(true), inCheck(board.isInCheck()), captureIndex(0), badCaptureCount(0), badCaptureIndex(0),
+      refutationCount(0), refutationIndex(0), quietIndex(0) {
+    // Outside check a quiet hash move is not a quiescence move
+    if (!inCheck && !hashMove.isCapture() && hashMove.promotion() != PieceType::QUEEN) {
+        this->hashMove = Move();
+    }
+}
+
+void MovePicker::selectBest(MoveList& list, size_t index) {
+    size_t best = index;
+    for (size_t i = index + 1; i < list.size(); i++) {
+        if (list[i].score > list[best].score) {
+            best = i;
+        }
+    }
+    if (best != index) {
+        std::swap(list[index], list[best]);
+    }
+}
+
+bool MovePicker::isRefutation(const Move& move) const {
+    for (int i = 0; i < refutationCount; i++) {
+        if (refutations[i] == move) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Move MovePicker::next() {
+    while (true) {
+        switch (stage) {
+        case Stage::HASH_MOVE:
+            stage = inCheck ? Stage::GENERATE_EVASIONS : Stage::GENERATE_CAPTURES;
+            if (board.isPseudoLegal(hashMove)) {
+                return hashMove;
+            }
+            hashMove = Move();
+            break;
+
+        case Stage::GENERATE_CAPTURES:
+            board.generateCaptures(captures);
+            for (ScoredMove& move : captures) {
+                move.score = engine.getCaptureScore(move, board);
+            }
+            stage = Stage::GOOD_CAPTURES;
+            break;
+
+        case Stage::GOOD_CAPTURES:
+            while (captureIndex < captures.size()) {
+                selectBest(captures, captureIndex);
+                const ScoredMove move = captures[captureIndex++];
+                if (move == hashMove) {
+                    continue;
+                }
+                // Quiescence search only looks at the queen among promotions
+                if (quiescence && move.isPromotion() && move.promotion() != PieceType::QUEEN) {
+                    continue;
+                }
+                // SEE only for the moves actually reached; losers wait for the last stage
+                if (!engine.seeGE(board, move, 0)) {
+                    captures[badCaptureCount++] = move;
+                    continue;
+                }
+                return move;
+            }
+            stage = quiescence ? Stage::DONE : Stage::GENERATE_REFUTATIONS;
+            break;
+
+        case Stage::GENERATE_REFUTATIONS: {
+            Move candidates[MAX_REFUTATIONS];
+            int candidateCount = 0;
+            if (!lastMove.isNull()) {
+                candidates[candidateCount++] = engine.getCounterMove(lastMove);
+                candidates[candidateCount++] = engine.getCountermoveHistory(lastMove);
+            }
+            if (ply >= 0 && ply < MAX_PLY) {
+                // Most recent killer first
+                for (int i = 0; i < 4; i++) {
+                    candidates[candidateCount++] = engine.killerMoves[ply][i];
+                }
+            }
+            // Captures and promotions were handed out already; the rest come
+            // from other positions and may not be playable in this one
+            for (int i = 0; i < candidateCount; i++) {
+                const Move& move = candidates[i];
+                if (move.isNull() || move == hashMove || move.isCapture() || move.isPromotion() ||
+                    isRefutation(move) || !board.isPseudoLegal(move)) {
+                    continue;
+                }
+                refutations[refutationCount++] = move;
+            }
+            stage = Stage::REFUTATIONS;
+            break;
+        }
+
+        case Stage::REFUTATIONS:
+            if (refutationIndex < refutationCount) {
+                return refutations[refutationIndex++];
+            }
+            stage = Stage::GENERATE_QUIETS;
+            break;
+
+        case Stage::GENERATE_QUIETS: {
+            board.generateQuiets(quiets);
+            Color side = board.getSideToMove();
+            for (ScoredMove& move : quiets) {
+                move.score = engine.getQuietMoveScore(move, board, side);
+            }
+            stage = Stage::QUIETS;
+            break;
+        }
+
+        case Stage::QUIETS:
+            while (quietIndex < quiets.size()) {
+                selectBest(quiets, quietIndex);
+                const ScoredMove move = quiets[quietIndex++];
+                if (move == hashMove || isRefutation(move)) {
+                    continue;
+                }
+                return move;
+            }
+            stage = Stage::BAD_CAPTURES;
+            break;
+
+        case Stage::BAD_CAPTURES:
+            if (badCaptureIndex < badCaptureCount) {
+                return captures[badCaptureIndex++];
+            }
+            stage = Stage::DONE;
+            break;
+
+        case Stage::GENERATE_EVASIONS: {
+            board.generateEvasions(quiets);
+            Color side = board.getSideToMove();
+            for (ScoredMove& move : quiets) {
+                // Captures of the checker first, then blocks and king moves
+                move.score = move.isCapture() || move.isPromotion()
+                                 ? EVASION_CAPTURE_BONUS + engine.getCaptureScore(move, board)
+                                 : engine.getQuietMoveScore(move, board, side);
+            }
+            stage = Stage::EVASIONS;
+            break;
+        }
+
+        case Stage::EVASIONS:
+            while (quietIndex < quiets.size()) {
+                selectBest(quiets, quietIndex);
+                const ScoredMove move = quiets[quietIndex++];
+                if (move == hashMove) {
+                    continue;
+                }
+                return move;
+            }
+            stage = Stage::DONE;
+            break;
+
+        case Stage::DONE:
+            return Move();
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include "board.h"
+
+class Engine;
+
+// Hands out the moves of a position one at a time, best first, generating and
+// scoring each group of moves only once the groups before it are used up:
+//
+//   1. the hash move (the TT move, or the PV move of an earlier iteration)
+//   2. captures and promotions that do not lose material (SEE), by MVV-LVA
+//   3. counter moves, then killer moves
+//   4. the remaining quiet moves, by history
+//   5. the captures that lose material
+//
+// Most cut nodes fail high on the hash move or the first capture and never
+// generate their quiet moves. The moves are pseudo-legal: the caller still
+// checks legality by making them (Board::makePseudoLegalMove).
+//
+// In check, the hash move is followed by the evasions instead, captures first
+// and then quiet moves by history. For quiescence search, only the winning and
+// even captures and queen promotions are given out (losing captures are
+// pruned), or the evasions when in check.
+class MovePicker
+{
+public:
+    // Main search
+    MovePicker(const Engine &engine, const Board &board, const Move &hashMove, int ply, const Move &lastMove);
+
+    // Quiescence search
+    MovePicker(const Engine &engine, const Board &board, const Move &hashMove);
+
+    // The next move to search, or the null move once every move has been given out
+    Move next();
+
+private:
+    enum class Stage
+    {
+        HASH_MOVE,
+        GENERATE_CAPTURES,
+        GOOD_CAPTURES,
+        GENERATE_REFUTATIONS,
+        REFUTATIONS,
+        GENERATE_QUIETS,
+        QUIETS,
+        BAD_CAPTURES,
+        GENERATE_EVASIONS,
+        EVASIONS,
+        DONE
+    };
+
+    static const int MAX_REFUTATIONS = 6; // Two counter moves and four killers
+
+    const Engine &engine;
+    const Board &board;
+    Move hashMove;
+    int ply;
+    Move lastMove;
+    Stage stage;
+    bool quiescence;
+    bool inCheck;
+
+    // Losing captures are moved to the front of the capture list as the good
+    // ones are handed out, and given out from there at the end
+    MoveList captures;
+    size_t captureIndex;
+    size_t badCaptureCount;
+    size_t badCaptureIndex;
+
+    Move refutations[MAX_REFUTATIONS];
+    int refutationCount;
+    int refutationIndex;
+
+    MoveList quiets; // Also holds the evasions
+    size_t quietIndex;
+
+    // Swap the best-scored move of list[index..] into list[index]
+    static void selectBest(MoveList &list, size_t index);
+
+    // Already given out by an earlier stage
+    bool isRefutation(const Move &move) const;
+};
+
+#endif // MOVE_PICKER_H
@@ -0,0 +1,98 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include "piece.h"
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+// A move with its ordering score stored right next to it, so a list can be
+// scored and sorted in place without a separate (score, move) array
+struct ScoredMove : public Move {
+    int score;
+
+    ScoredMove() : Move(), score(0) {}
+    ScoredMove(const Move& move, int s = 0) : Move(move), score(s) {}
+};
+
+// Fixed-capacity move list that lives on the stack. No reachable chess
+// position has more than 218 legal moves, so 256 slots are always enough and
+// move generation never touches the heap.
+class MoveList {
+public:
+    static const int CAPACITY = 256;
+
+    MoveList() : count(0) {}
+
+    void push_back(const Move& move) {
+        assert(count < CAPACITY);
+        moves[count++] = ScoredMove(move);
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        assert(count < CAPACITY);
+        moves[count++] = ScoredMove(Move(std::forward<Args>(args)...));
+    }
+
+    // Drop everything past the first n entries (never grows the list)
+    void resize(size_t n) {
+        if (n < static_cast<size_t>(count)) count = static_cast<int>(n);
+    }
+
+    void clear() { count = 0; }
+    size_t size() const { return static_cast<size_t>(count); }
+    bool empty() const { return count == 0; }
+
+    ScoredMove& operator[](size_t index) { return moves[index]; }
+    const ScoredMove& operator[](size_t index) const { return moves[index]; }
+
+    ScoredMove* begin() { return moves; }
+    ScoredMove* end() { return moves + count; }
+    const ScoredMove* begin() const { return moves; }
+    const ScoredMove* end() const { return moves + count; }
+
+private:
+    ScoredMove moves[CAPACITY];
+    int count;
+};
+
+// Fixed-capacity principal variation line. Search writes one per ply, so
+// it is sized for the deepest line the search can produce rather than for
+// a move list.
+class PVLine {
+public:
+    static const int CAPACITY = 128;
+
+    PVLine() : length(0) {}
+
+    void clear() { length = 0; }
+    size_t size() const { return static_cast<size_t>(length); }
+    bool empty() const { return length == 0; }
+
+    void push_back(const Move& move) {
+        if (length < CAPACITY) moves[length++] = move;
+    }
+
+    // Replace this line with move followed by the child's line
+    void update(const Move& move, const PVLine& child) {
+        moves[0] = move;
+        int childLength = child.length < CAPACITY - 1 ? child.length : CAPACITY - 1;
+        for (int i = 0; i < childLength; i++) {
+            moves[i + 1] = child.moves[i];
+        }
+        length = childLength + 1;
+    }
+
+    Move& operator[](size_t index) { return moves[index]; }
+    const Move& operator[](size_t index) const { return moves[index]; }
+
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + length; }
+
+private:
+    Move moves[CAPACITY];
+    int length;
+};
+
+#endif // MOVELIST_H
@@ -0,0 +1,53 @@
+#include "pawn_hash.h"
+
+PawnHashTable::PawnHashTable(int sizeMB) : entryCount(0), entryMask(0), sizeMB(0), probes(0), hits(0) {
+    resize(sizeMB);
+}
+
+void PawnHashTable::resize(int newSizeMB) {
+    if (newSizeMB < 1) newSizeMB = 1;
+    if (table && newSizeMB == sizeMB) return;
+
+    size_t numEntries = (static_cast<size_t>(newSizeMB) * 1024 * 1024) / sizeof(PawnEntry);
+
+    // Round down to a power of 2 so the index is a simple mask
+    size_t powerOf2 = 1;
+    while (powerOf2 * 2 <= numEntries) {
+        powerOf2 *= 2;
+    }
+
+    sizeMB = newSizeMB;
+    entryCount = powerOf2;
+    entryMask = entryCount - 1;
+    table.reset(new PawnEntry[entryCount]);
+    clear();
+}
+
+PawnEntry* PawnHashTable::probe(uint64_t key, bool& found) {
+    PawnEntry& entry = table[key & entryMask];
+    probes++;
+
+    found = entry.key == key;
+    if (found) {
+        hits++;
+    }
+    return &entry;
+}
+
+PawnEntry* PawnHashTable::find(uint64_t key) {
+    PawnEntry& entry = table[key & entryMask];
+    return entry.key == key ? &entry : nullptr;
+}
+
+void PawnHashTable::clear() {
+    // A zeroed entry is a valid answer for key 0 (no pawns at all): score 0 and
+    // no passed pawns. The shelter is marked as not yet computed.
+    for (size_t i = 0; i < entryCount; i++) {
+        table[i].key = 0;
+        table[i].score = 0;
+        table[i].passed[0] = table[i].passed[1] = 0;
+        table[i].kingSquare[0] = table[i].kingSquare[1] = -1;
+        table[i].shelter[0] = table[i].shelter[1] = 0;
+    }
+    resetStats();
+}
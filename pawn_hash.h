@@ -0,0 +1,60 @@
+#ifndef PAWN_HASH_H
+#define PAWN_HASH_H
+
+#include "common.h"
+#include "bitboard.h"
+
+// Cached pawn-structure evaluation for one pawn configuration
+struct PawnEntry
+{
+    uint64_t key;          // Pawn-only Zobrist key (Board::getPawnKey)
+    int score;             // Pawn structure, white minus black, before weighting
+    Bitboard passed[2];    // Passed pawns per color [white, black]
+    int kingSquare[2];     // King square the shelter below was computed for (-1 = none)
+    int shelter[2];        // Pawn shelter in front of that king square
+};
+
+// Pawn structure changes far less often than the rest of the position, so a
+// small direct-mapped table keyed by the pawn key answers almost every probe.
+// Each search thread owns one; entries are not shared between threads.
+class PawnHashTable
+{
+private:
+    std::unique_ptr<PawnEntry[]> table;
+    size_t entryCount;
+    size_t entryMask;
+    int sizeMB;
+
+    long probes;
+    long hits;
+
+public:
+    // Constructor with table size in megabytes
+    PawnHashTable(int sizeMB = 2);
+
+    // Resize the table (rounded down to a power-of-two number of entries)
+    void resize(int sizeMB);
+
+    // Entry slot for a pawn key. Sets found when it already holds that key;
+    // otherwise the caller is expected to fill it in.
+    PawnEntry *probe(uint64_t key, bool &found);
+
+    // Pull the entry for key into the cache ahead of a probe
+    void prefetch(uint64_t key) const { prefetchLine(&table[key & entryMask]); }
+
+    // Entry for a pawn key if present, without touching the statistics
+    PawnEntry *find(uint64_t key);
+
+    // Clear the table
+    void clear();
+
+    // Probe statistics since the last resetStats()
+    void resetStats() { probes = 0; hits = 0; }
+    long getProbes() const { return probes; }
+    long getHits() const { return hits; }
+
+    int getSizeMB() const { return sizeMB; }
+    size_t getSize() const { return entryCount; }
+};
+
+#endif // PAWN_HASH_H
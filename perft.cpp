@@ -23,31 +23,14 @@ PerftTester::PerftResult PerftTester::perftRecursive(Board& board, int depth, bo
     for (const auto& move : legalMoves) {
         BoardState previousState;
         
-        // Check move characteristics before making the move
-        bool isCapture = board.getPieceAt(move.to) != nullptr;
-        bool isEnPassant = false;
-        bool isCastle = false;
-        bool isPromotion = move.promotion != PieceType::NONE;
-        
-        auto movingPiece = board.getPieceAt(move.from);
-        if (movingPiece) {
-            // Check for en passant
-            if (movingPiece->getType() == PieceType::PAWN && 
-                move.to == board.getEnPassantTarget()) {
-                isEnPassant = true;
-                isCapture = true; // En passant is a capture
-            }
-            
-            // Check for castling
-            if (movingPiece->getType() == PieceType::KING) {
-                if (abs(move.to.col - move.from.col) == 2) {
-                    isCastle = true;
-                }
-            }
-        }
+        // Move characteristics come straight from the generator's flags
+        bool isCapture = move.isCapture(); // Includes en passant
+        bool isEnPassant = move.isEnPassant();
+        bool isCastle = move.isCastle();
+        bool isPromotion = move.isPromotion();
         
         // Make the move
-        if (!board.makeMove(move, previousState)) {
+        if (!board.makePseudoLegalMove(move, previousState)) {
             std::cerr << "Error: Invalid move generated: " << move.toString() << std::endl;
             continue;
         }
@@ -325,7 +308,7 @@ bool PerftTester::testEnPassant() {
     bool foundWhiteEP = false;
     
     for (const auto& move : moves1) {
-        if (move.from == Position(4, 4) && move.to == Position(5, 5)) { // e5xf6
+        if (move.from() == Position(4, 4) && move.to() == Position(5, 5)) { // e5xf6
             foundWhiteEP = true;
             std::cout << "  ✓ Found white en passant: " << move.toString() << std::endl;
             break;
@@ -346,7 +329,7 @@ bool PerftTester::testEnPassant() {
     bool foundBlackEP = false;
     
     for (const auto& move : moves2) {
-        if (move.from == Position(3, 4) && move.to == Position(2, 3)) { // exd3
+        if (move.from() == Position(3, 4) && move.to() == Position(2, 3)) { // exd3
             foundBlackEP = true;
             std::cout << "  ✓ Found black en passant: " << move.toString() << std::endl;
             break;
@@ -367,7 +350,7 @@ bool PerftTester::testEnPassant() {
     bool foundInvalidEP = false;
     
     for (const auto& move : moves3) {
-        if (move.from == Position(4, 4) && move.to == Position(5, 3)) { // e5xd6
+        if (move.from() == Position(4, 4) && move.to() == Position(5, 3)) { // e5xd6
             foundInvalidEP = true;
             break;
         }
@@ -399,11 +382,11 @@ bool PerftTester::testCastling() {
     bool foundBlackKingside = false, foundBlackQueenside = false;
     
     for (const auto& move : moves1) {
-        if (move.from == Position(0, 4) && move.to == Position(0, 6)) {
+        if (move.from() == Position(0, 4) && move.to() == Position(0, 6)) {
             foundWhiteKingside = true;
             std::cout << "  ✓ Found white kingside castling" << std::endl;
         }
-        if (move.from == Position(0, 4) && move.to == Position(0, 2)) {
+        if (move.from() == Position(0, 4) && move.to() == Position(0, 2)) {
             foundWhiteQueenside = true;
             std::cout << "  ✓ Found white queenside castling" << std::endl;
         }
@@ -414,11 +397,11 @@ bool PerftTester::testCastling() {
     auto blackMoves = board1.generateLegalMoves();
     
     for (const auto& move : blackMoves) {
-        if (move.from == Position(7, 4) && move.to == Position(7, 6)) {
+        if (move.from() == Position(7, 4) && move.to() == Position(7, 6)) {
             foundBlackKingside = true;
             std::cout << "  ✓ Found black kingside castling" << std::endl;
         }
-        if (move.from == Position(7, 4) && move.to == Position(7, 2)) {
+        if (move.from() == Position(7, 4) && move.to() == Position(7, 2)) {
             foundBlackQueenside = true;
             std::cout << "  ✓ Found black queenside castling" << std::endl;
         }
@@ -438,8 +421,8 @@ bool PerftTester::testCastling() {
     bool foundBlockedCastling = false;
     
     for (const auto& move : moves2) {
-        if ((move.from == Position(0, 4) && move.to == Position(0, 6)) ||
-            (move.from == Position(0, 4) && move.to == Position(0, 2))) {
+        if ((move.from() == Position(0, 4) && move.to() == Position(0, 6)) ||
+            (move.from() == Position(0, 4) && move.to() == Position(0, 2))) {
             foundBlockedCastling = true;
             break;
         }
@@ -471,15 +454,15 @@ bool PerftTester::testPromotion() {
     std::set<PieceType> promotionTypes;
     
     for (const auto& move : moves1) {
-        if (move.from == Position(6, 0) && move.to == Position(7, 0)) {
-            if (move.promotion != PieceType::NONE) {
+        if (move.from() == Position(6, 0) && move.to() == Position(7, 0)) {
+            if (move.promotion() != PieceType::NONE) {
                 whitePromotionMoves++;
-                promotionTypes.insert(move.promotion);
+                promotionTypes.insert(move.promotion());
                 std::cout << "  ✓ Found promotion to " << 
-                    (move.promotion == PieceType::QUEEN ? "Queen" :
-                     move.promotion == PieceType::ROOK ? "Rook" :
-                     move.promotion == PieceType::BISHOP ? "Bishop" :
-                     move.promotion == PieceType::KNIGHT ? "Knight" : "Unknown") << std::endl;
+                    (move.promotion() == PieceType::QUEEN ? "Queen" :
+                     move.promotion() == PieceType::ROOK ? "Rook" :
+                     move.promotion() == PieceType::BISHOP ? "Bishop" :
+                     move.promotion() == PieceType::KNIGHT ? "Knight" : "Unknown") << std::endl;
             }
         }
     }
@@ -503,8 +486,8 @@ bool PerftTester::testPromotion() {
     int blackPromotionMoves = 0;
     
     for (const auto& move : moves2) {
-        if (move.from == Position(1, 7) && move.to == Position(0, 7)) {
-            if (move.promotion != PieceType::NONE) {
+        if (move.from() == Position(1, 7) && move.to() == Position(0, 7)) {
+            if (move.promotion() != PieceType::NONE) {
                 blackPromotionMoves++;
             }
         }
@@ -522,10 +505,10 @@ bool PerftTester::testPromotion() {
     bool foundUnderPromotion = false;
     
     for (const auto& move : moves1) {
-        if (move.from == Position(6, 0) && move.to == Position(7, 0)) {
-            if (move.promotion == PieceType::KNIGHT || 
-                move.promotion == PieceType::BISHOP || 
-                move.promotion == PieceType::ROOK) {
+        if (move.from() == Position(6, 0) && move.to() == Position(7, 0)) {
+            if (move.promotion() == PieceType::KNIGHT || 
+                move.promotion() == PieceType::BISHOP || 
+                move.promotion() == PieceType::ROOK) {
                 foundUnderPromotion = true;
                 break;
             }
@@ -48,33 +48,109 @@ struct Position {
     }
 };
 
+// Compact 16-bit move.
+//   bits 0-5   from square (row * 8 + col, a1 = 0)
+//   bits 6-11  to square
+//   bits 12-15 flags: quiet, double pawn push, castles, capture, en passant, promotions
+// The all-zero value (a1a1) is never a legal move and serves as the null move.
 class Move {
 public:
-    Position from;
-    Position to;
-    PieceType promotion;
-    
-    // ADDED: Default constructor to fix compilation error
-    Move() : from(Position()), to(Position()), promotion(PieceType::NONE) {}
-    
-    Move(Position f, Position t, PieceType p = PieceType::NONE)
-        : from(f), to(t), promotion(p) {}
-    
+    enum Flag : uint16_t {
+        QUIET = 0,
+        DOUBLE_PAWN_PUSH = 1,
+        KING_CASTLE = 2,
+        QUEEN_CASTLE = 3,
+        CAPTURE = 4,          // Set on every capture, including promotion captures
+        EN_PASSANT = 5,
+        PROMOTION = 8         // Low two bits select knight, bishop, rook or queen
+    };
+
+    Move() : data(0) {}
+
+    // Build a move from squares and flags (used by the move generators)
+    Move(int fromSquare, int toSquare, int flags)
+        : data(static_cast<uint16_t>(fromSquare | (toSquare << 6) | (flags << 12))) {}
+
+    // Build a move from positions. Only the promotion is encoded; capture,
+    // en passant and castling flags need the board and are set by the generators.
+    Move(Position f, Position t, PieceType p = PieceType::NONE) : data(0) {
+        if (f.isValid() && t.isValid()) {
+            int flags = (p == PieceType::NONE) ? QUIET : promotionFlag(p);
+            data = static_cast<uint16_t>((f.row * 8 + f.col) | ((t.row * 8 + t.col) << 6) | (flags << 12));
+        }
+    }
+
+    // Flag bits for promoting to the given piece type (add CAPTURE for promotion captures)
+    static int promotionFlag(PieceType p) {
+        return PROMOTION | (static_cast<int>(p) - static_cast<int>(PieceType::KNIGHT));
+    }
+
+    int fromSquare() const { return data & 0x3F; }
+    int toSquare() const { return (data >> 6) & 0x3F; }
+    int flags() const { return data >> 12; }
+
+    // Positions of the move; both are invalid for the null move
+    Position from() const { return isNull() ? Position() : Position(fromSquare() >> 3, fromSquare() & 7); }
+    Position to() const { return isNull() ? Position() : Position(toSquare() >> 3, toSquare() & 7); }
+
+    PieceType promotion() const {
+        return isPromotion() ? static_cast<PieceType>(static_cast<int>(PieceType::KNIGHT) + (flags() & 3))
+                             : PieceType::NONE;
+    }
+
+    bool isNull() const { return data == 0; }
+    bool isCapture() const { return (flags() & CAPTURE) != 0; }
+    bool isEnPassant() const { return flags() == EN_PASSANT; }
+    bool isCastle() const { return flags() == KING_CASTLE || flags() == QUEEN_CASTLE; }
+    bool isPromotion() const { return (flags() & PROMOTION) != 0; }
+
+    // Raw 16-bit encoding, for compact tables
+    uint16_t raw() const { return data; }
+    static Move fromRaw(uint16_t raw) {
+        Move move;
+        move.data = raw;
+        return move;
+    }
+
+    bool operator==(const Move& other) const { return data == other.data; }
+    bool operator!=(const Move& other) const { return data != other.data; }
+
+    // Same squares and promotion piece, ignoring the board-derived flags
+    bool sameAs(const Move& other) const {
+        return ((data ^ other.data) & 0x0FFF) == 0 && promotion() == other.promotion();
+    }
+
+    // Long algebraic notation ("e2e4", "e7e8q"); the null move is "0000"
     std::string toString() const {
-        std::string result = from.toString() + to.toString();
-        if (promotion != PieceType::NONE) {
-            char promChar = ' ';
-            switch (promotion) {
-                case PieceType::QUEEN: promChar = 'q'; break;
-                case PieceType::ROOK: promChar = 'r'; break;
-                case PieceType::BISHOP: promChar = 'b'; break;
-                case PieceType::KNIGHT: promChar = 'n'; break;
+        if (isNull()) return "0000";
+        std::string result = from().toString() + to().toString();
+        if (isPromotion()) {
+            static const char promotionChars[] = "nbrq";
+            result += promotionChars[flags() & 3];
+        }
+        return result;
+    }
+
+    // Parse long algebraic notation; returns the null move on malformed input
+    static Move fromString(const std::string& str) {
+        if (str.length() < 4) return Move();
+        Position f = Position::fromString(str.substr(0, 2));
+        Position t = Position::fromString(str.substr(2, 2));
+        PieceType promotion = PieceType::NONE;
+        if (str.length() > 4) {
+            switch (str[4]) {
+                case 'q': promotion = PieceType::QUEEN; break;
+                case 'r': promotion = PieceType::ROOK; break;
+                case 'b': promotion = PieceType::BISHOP; break;
+                case 'n': promotion = PieceType::KNIGHT; break;
                 default: break;
             }
-            result += promChar;
         }
-        return result;
+        return Move(f, t, promotion);
     }
+
+private:
+    uint16_t data;
 };
 
 class Piece {
@@ -99,7 +175,8 @@ public:
     void setMoved() { hasMoved = true; }
     void setHasMoved(bool moved) { hasMoved = moved; }
     
-    virtual std::vector<Move> getLegalMoves(const class Board& board) const = 0;
+    // Append this piece's moves to the caller's (stack-allocated) list
+    virtual void getLegalMoves(const class Board& board, class MoveList& moves) const = 0;
     
     // Helper to check if move is on board and doesn't capture own piece
     bool isBasicallyValid(const Position& pos, const Board& board) const;
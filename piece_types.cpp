@@ -1,33 +1,47 @@
 #include "piece_types.h"
 #include "board.h"
 
+// Turn a bitboard of destination squares into moves from a single square,
+// flagging the ones that land on an enemy piece as captures
+static void addMovesTo(Bitboard targets, const Position& from, const Board& board, MoveList& moves) {
+    int fromSquare = Bitboards::toSquare(from);
+    Color enemy = (board.getPieceColorAt(fromSquare) == Color::WHITE) ? Color::BLACK : Color::WHITE;
+    Bitboard enemies = board.getPieces(enemy);
+    while (targets) {
+        int to = Bitboards::popLsb(targets);
+        moves.emplace_back(fromSquare, to, (enemies & Bitboards::squareBB(to)) ? Move::CAPTURE : Move::QUIET);
+    }
+}
+
 // Pawn::getLegalMoves() 
-std::vector<Move> Pawn::getLegalMoves(const Board& board) const {
-    std::vector<Move> moves;
+void Pawn::getLegalMoves(const Board& board, MoveList& moves) const {
     int direction = (color == Color::WHITE) ? 1 : -1;
     Position front(position.row + direction, position.col);
     
     // Helper function to add promotion moves correctly
-    auto addPromotionMoves = [&](Position from, Position to) {
+    auto addPromotionMoves = [&](Position from, Position to, int captureFlag) {
+        int fromSquare = Bitboards::toSquare(from);
+        int toSquare = Bitboards::toSquare(to);
+        
         // ENHANCED: Validate promotion is only on correct ranks
         bool isPromotionRank = (color == Color::WHITE && to.row == 7) || 
                               (color == Color::BLACK && to.row == 0);
         
         if (isPromotionRank) {
             // Add all four promotion options
-            moves.emplace_back(from, to, PieceType::QUEEN);
-            moves.emplace_back(from, to, PieceType::ROOK);
-            moves.emplace_back(from, to, PieceType::BISHOP);
-            moves.emplace_back(from, to, PieceType::KNIGHT);
+            moves.emplace_back(fromSquare, toSquare, Move::promotionFlag(PieceType::QUEEN) | captureFlag);
+            moves.emplace_back(fromSquare, toSquare, Move::promotionFlag(PieceType::ROOK) | captureFlag);
+            moves.emplace_back(fromSquare, toSquare, Move::promotionFlag(PieceType::BISHOP) | captureFlag);
+            moves.emplace_back(fromSquare, toSquare, Move::promotionFlag(PieceType::KNIGHT) | captureFlag);
         } else {
             // Regular move (no promotion)
-            moves.emplace_back(from, to);
+            moves.emplace_back(fromSquare, toSquare, captureFlag);
         }
     };
     
     // Forward move (1 square)
     if (front.isValid() && !board.getPieceAt(front)) {
-        addPromotionMoves(position, front);
+        addPromotionMoves(position, front, Move::QUIET);
         
         // Forward move (2 squares) if pawn is on starting row
         bool isStartingRank = (color == Color::WHITE && position.row == 1) || 
@@ -36,7 +50,8 @@ std::vector<Move> Pawn::getLegalMoves(const Board& board) const {
         if (isStartingRank) {
             Position doubleFront(position.row + 2 * direction, position.col);
             if (doubleFront.isValid() && !board.getPieceAt(doubleFront)) {
-                moves.emplace_back(position, doubleFront); // No promotion on double move
+                // No promotion on double move
+                moves.emplace_back(Bitboards::toSquare(position), Bitboards::toSquare(doubleFront), Move::DOUBLE_PAWN_PUSH);
             }
         }
     }
@@ -50,7 +65,7 @@ std::vector<Move> Pawn::getLegalMoves(const Board& board) const {
             
             // Regular capture
             if (pieceAtCapture && pieceAtCapture->getColor() != color) {
-                addPromotionMoves(position, capturePos);
+                addPromotionMoves(position, capturePos, Move::CAPTURE);
             }
          // En passant capture - CRITICAL FIX: Complete validation
 else if (capturePos == board.getEnPassantTarget() && board.getEnPassantTarget().isValid()) {
@@ -77,154 +92,47 @@ else if (capturePos == board.getEnPassantTarget() && board.getEnPassantTarget().
             
             if (capturedPawnOnCorrectRank) {
                 // En passant is valid (never results in promotion)
-                moves.emplace_back(position, capturePos);
+                moves.emplace_back(Bitboards::toSquare(position), Bitboards::toSquare(capturePos), Move::EN_PASSANT);
             }
         }
     }
 }
         }
     }
-    
-    return moves;
 }
 
 // Knight movement logic
-std::vector<Move> Knight::getLegalMoves(const Board& board) const {
-    std::vector<Move> moves;
-    const std::vector<std::pair<int, int>> knightOffsets = {
-        {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
-        {1, -2}, {1, 2}, {2, -1}, {2, 1}
-    };
-    
-    for (const auto& offset : knightOffsets) {
-        Position newPos(position.row + offset.first, position.col + offset.second);
-        
-        if (isBasicallyValid(newPos, board)) {
-            moves.emplace_back(position, newPos);
-        }
-    }
-    
-    return moves;
+void Knight::getLegalMoves(const Board& board, MoveList& moves) const {
+    Bitboard targets = Bitboards::knightAttacks(Bitboards::toSquare(position)) & ~board.getPieces(color);
+    addMovesTo(targets, position, board, moves);
 }
 
 // Bishop movement logic
-std::vector<Move> Bishop::getLegalMoves(const Board& board) const {
-    std::vector<Move> moves;
-    const std::vector<std::pair<int, int>> directions = {
-        {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
-    };
-    
-    for (const auto& dir : directions) {
-        for (int distance = 1; distance < 8; distance++) {
-            Position newPos(position.row + dir.first * distance, 
-                          position.col + dir.second * distance);
-            
-            if (!newPos.isValid()) break;
-            
-            auto pieceAtDest = board.getPieceAt(newPos);
-            
-            if (!pieceAtDest) {
-                // Empty square, can move here
-                moves.emplace_back(position, newPos);
-            } else if (pieceAtDest->getColor() != color) {
-                // Capture opponent's piece
-                moves.emplace_back(position, newPos);
-                break;
-            } else {
-                // Blocked by own piece
-                break;
-            }
-        }
-    }
-    
-    return moves;
+void Bishop::getLegalMoves(const Board& board, MoveList& moves) const {
+    Bitboard targets = Bitboards::bishopAttacks(Bitboards::toSquare(position), board.getOccupied()) &
+                       ~board.getPieces(color);
+    addMovesTo(targets, position, board, moves);
 }
 
 // Rook movement logic
-std::vector<Move> Rook::getLegalMoves(const Board& board) const {
-    std::vector<Move> moves;
-    const std::vector<std::pair<int, int>> directions = {
-        {-1, 0}, {1, 0}, {0, -1}, {0, 1}
-    };
-    
-    for (const auto& dir : directions) {
-        for (int distance = 1; distance < 8; distance++) {
-            Position newPos(position.row + dir.first * distance, 
-                          position.col + dir.second * distance);
-            
-            if (!newPos.isValid()) break;
-            
-            auto pieceAtDest = board.getPieceAt(newPos);
-            
-            if (!pieceAtDest) {
-                // Empty square, can move here
-                moves.emplace_back(position, newPos);
-            } else if (pieceAtDest->getColor() != color) {
-                // Capture opponent's piece
-                moves.emplace_back(position, newPos);
-                break;
-            } else {
-                // Blocked by own piece
-                break;
-            }
-        }
-    }
-    
-    return moves;
+void Rook::getLegalMoves(const Board& board, MoveList& moves) const {
+    Bitboard targets = Bitboards::rookAttacks(Bitboards::toSquare(position), board.getOccupied()) &
+                       ~board.getPieces(color);
+    addMovesTo(targets, position, board, moves);
 }
 
 // Queen movement logic
-std::vector<Move> Queen::getLegalMoves(const Board& board) const {
-    std::vector<Move> moves;
-    const std::vector<std::pair<int, int>> directions = {
-        {-1, -1}, {-1, 0}, {-1, 1},
-        {0, -1},           {0, 1},
-        {1, -1},  {1, 0},  {1, 1}
-    };
-    
-    for (const auto& dir : directions) {
-        for (int distance = 1; distance < 8; distance++) {
-            Position newPos(position.row + dir.first * distance, 
-                          position.col + dir.second * distance);
-            
-            if (!newPos.isValid()) break;
-            
-            auto pieceAtDest = board.getPieceAt(newPos);
-            
-            if (!pieceAtDest) {
-                // Empty square, can move here
-                moves.emplace_back(position, newPos);
-            } else if (pieceAtDest->getColor() != color) {
-                // Capture opponent's piece
-                moves.emplace_back(position, newPos);
-                break;
-            } else {
-                // Blocked by own piece
-                break;
-            }
-        }
-    }
-    
-    return moves;
+void Queen::getLegalMoves(const Board& board, MoveList& moves) const {
+    Bitboard targets = Bitboards::queenAttacks(Bitboards::toSquare(position), board.getOccupied()) &
+                       ~board.getPieces(color);
+    addMovesTo(targets, position, board, moves);
 }
 
 // King movement logic
-std::vector<Move> King::getLegalMoves(const Board& board) const {
-    std::vector<Move> moves;
-    const std::vector<std::pair<int, int>> directions = {
-        {-1, -1}, {-1, 0}, {-1, 1},
-        {0, -1},           {0, 1},
-        {1, -1},  {1, 0},  {1, 1}
-    };
-    
+void King::getLegalMoves(const Board& board, MoveList& moves) const {
     // Regular moves
-    for (const auto& dir : directions) {
-        Position newPos(position.row + dir.first, position.col + dir.second);
-        
-        if (isBasicallyValid(newPos, board)) {
-            moves.emplace_back(position, newPos);
-        }
-    }
+    Bitboard targets = Bitboards::kingAttacks(Bitboards::toSquare(position)) & ~board.getPieces(color);
+    addMovesTo(targets, position, board, moves);
     
     // Castling moves
     if (!hasMoved && !board.isInCheck()) {
@@ -244,7 +152,7 @@ std::vector<Move> King::getLegalMoves(const Board& board) const {
                     !board.isSquareAttacked(Position(position.row, position.col + 2), 
                                          (color == Color::WHITE) ? Color::BLACK : Color::WHITE)) {
                     
-                    moves.emplace_back(position, kingsidePos);
+                    moves.emplace_back(Bitboards::toSquare(position), Bitboards::toSquare(kingsidePos), Move::KING_CASTLE);
                 }
             }
         }
@@ -266,11 +174,10 @@ std::vector<Move> King::getLegalMoves(const Board& board) const {
                     !board.isSquareAttacked(Position(position.row, position.col - 2), 
                                          (color == Color::WHITE) ? Color::BLACK : Color::WHITE)) {
                     
-                    moves.emplace_back(position, queensidePos);
+                    moves.emplace_back(Bitboards::toSquare(position), Bitboards::toSquare(queensidePos), Move::QUEEN_CASTLE);
                 }
             }
         }
     }
     
-    return moves;
 }
\ No newline at end of file
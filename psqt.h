@@ -0,0 +1,123 @@
+#ifndef PSQT_H
+#define PSQT_H
+
+#include "piece.h"
+
+// Piece values and piece-square tables. Board keeps running totals of these
+// as pieces are placed and removed, so the engine's static evaluation reads
+// them in O(1) instead of rescanning the board.
+namespace PSQT {
+
+static const int PAWN_VALUE = 100;
+static const int KNIGHT_VALUE = 320;
+static const int BISHOP_VALUE = 330;
+static const int ROOK_VALUE = 500;
+static const int QUEEN_VALUE = 900;
+static const int KING_VALUE = 20000;
+
+// Game phase: knights and bishops count 1, rooks 2, queens 4, so the
+// starting position is MAX_PHASE and bare kings (plus pawns) are 0
+static const int MAX_PHASE = 24;
+
+// Only the king has separate middlegame and endgame tables; the other pieces
+// use the same table in both stages
+enum Stage { MIDDLEGAME = 0, ENDGAME = 1 };
+
+namespace detail {
+
+// Tables are indexed row * 8 + col from white's side; black reads them mirrored
+constexpr int PAWN_TABLE[64] = {
+    0, 0, 0, 0, 0, 0, 0, 0,
+    50, 50, 50, 50, 50, 50, 50, 50,
+    10, 10, 20, 30, 30, 20, 10, 10,
+    5, 5, 10, 25, 25, 10, 5, 5,
+    0, 0, 0, 20, 20, 0, 0, 0,
+    5, -5, -10, 0, 0, -10, -5, 5,
+    5, 10, 10, -20, -20, 10, 10, 5,
+    0, 0, 0, 0, 0, 0, 0, 0};
+
+constexpr int KNIGHT_TABLE[64] = {
+    -50, -40, -30, -30, -30, -30, -40, -50,
+    -40, -20, 0, 0, 0, 0, -20, -40,
+    -30, 0, 10, 15, 15, 10, 0, -30,
+    -30, 5, 15, 20, 20, 15, 5, -30,
+    -30, 0, 15, 20, 20, 15, 0, -30,
+    -30, 5, 10, 15, 15, 10, 5, -30,
+    -40, -20, 0, 5, 5, 0, -20, -40,
+    -50, -40, -30, -30, -30, -30, -40, -50};
+
+constexpr int BISHOP_TABLE[64] = {
+    -20, -10, -10, -10, -10, -10, -10, -20,
+    -10, 0, 0, 0, 0, 0, 0, -10,
+    -10, 0, 10, 10, 10, 10, 0, -10,
+    -10, 5, 5, 10, 10, 5, 5, -10,
+    -10, 0, 5, 10, 10, 5, 0, -10,
+    -10, 5, 5, 5, 5, 5, 5, -10,
+    -10, 0, 5, 0, 0, 5, 0, -10,
+    -20, -10, -10, -10, -10, -10, -10, -20};
+
+constexpr int ROOK_TABLE[64] = {
+    0, 0, 0, 0, 0, 0, 0, 0,
+    5, 10, 10, 10, 10, 10, 10, 5,
+    -5, 0, 0, 0, 0, 0, 0, -5,
+    -5, 0, 0, 0, 0, 0, 0, -5,
+    -5, 0, 0, 0, 0, 0, 0, -5,
+    -5, 0, 0, 0, 0, 0, 0, -5,
+    -5, 0, 0, 0, 0, 0, 0, -5,
+    0, 0, 0, 5, 5, 0, 0, 0};
+
+constexpr int QUEEN_TABLE[64] = {
+    -20, -10, -10, -5, -5, -10, -10, -20,
+    -10, 0, 0, 0, 0, 0, 0, -10,
+    -10, 0, 5, 5, 5, 5, 0, -10,
+    -5, 0, 5, 5, 5, 5, 0, -5,
+    0, 0, 5, 5, 5, 5, 0, -5,
+    -10, 5, 5, 5, 5, 5, 0, -10,
+    -10, 0, 5, 0, 0, 0, 0, -10,
+    -20, -10, -10, -5, -5, -10, -10, -20};
+
+constexpr int KING_MIDDLEGAME_TABLE[64] = {
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -30, -40, -40, -50, -50, -40, -40, -30,
+    -20, -30, -30, -40, -40, -30, -30, -20,
+    -10, -20, -20, -20, -20, -20, -20, -10,
+    20, 20, 0, 0, 0, 0, 20, 20,
+    20, 30, 10, 0, 0, 10, 30, 20};
+
+constexpr int KING_ENDGAME_TABLE[64] = {
+    -50, -40, -30, -20, -20, -30, -40, -50,
+    -30, -20, -10, 0, 0, -10, -20, -30,
+    -30, -10, 20, 30, 30, 20, -10, -30,
+    -30, -10, 30, 40, 40, 30, -10, -30,
+    -30, -10, 30, 40, 40, 30, -10, -30,
+    -30, -10, 20, 30, 30, 20, -10, -30,
+    -30, -30, 0, 0, 0, 0, -30, -30,
+    -50, -30, -30, -30, -30, -30, -30, -50};
+
+constexpr int PIECE_VALUES[6] = {PAWN_VALUE, KNIGHT_VALUE, BISHOP_VALUE, ROOK_VALUE, QUEEN_VALUE, 0};
+constexpr int PHASE_WEIGHTS[6] = {0, 1, 1, 2, 4, 0};
+
+constexpr const int* TABLES[2][6] = {
+    {PAWN_TABLE, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE, KING_MIDDLEGAME_TABLE},
+    {PAWN_TABLE, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE, KING_ENDGAME_TABLE}
+};
+
+} // namespace detail
+
+// Material value of a piece type for the running material total (kings count 0)
+inline int material(PieceType type) { return detail::PIECE_VALUES[static_cast<int>(type)]; }
+
+// Contribution of a piece type to the game phase
+inline int phaseWeight(PieceType type) { return detail::PHASE_WEIGHTS[static_cast<int>(type)]; }
+
+// Piece-square bonus for a piece of the given color on square (row * 8 + col)
+inline int bonus(Stage stage, Color color, PieceType type, int square) {
+    int index = (color == Color::WHITE) ? square : (square ^ 56);
+    return detail::TABLES[stage][static_cast<int>(type)][index];
+}
+
+} // namespace PSQT
+
+#endif // PSQT_H
@@ -88,11 +88,11 @@ public:
                 int eval = engine.evaluatePosition(game.getBoard());
                 
                 // Convert move to string format
-                std::string moveStr = bestMove.from.toString() + bestMove.to.toString();
+                std::string moveStr = bestMove.from().toString() + bestMove.to().toString();
                 
                 // Add promotion if needed
-                if (bestMove.promotion != PieceType::NONE) {
-                    switch (bestMove.promotion) {
+                if (bestMove.promotion() != PieceType::NONE) {
+                    switch (bestMove.promotion()) {
                         case PieceType::QUEEN: moveStr += "q"; break;
                         case PieceType::ROOK: moveStr += "r"; break;
                         case PieceType::BISHOP: moveStr += "b"; break;
@@ -0,0 +1,108 @@
+#include "result_cache.h"
+#include "engine.h"
+
+CachedResult CachedResult::fromSearch(const Engine& engine, const Move& bestMove) {
+    CachedResult result;
+    result.move = bestMove;
+    if (bestMove.isNull()) {
+        result.depth = MAX_PLY;
+        return result;
+    }
+    result.eval = engine.getLastScore();
+    result.depth = engine.getLastDepth();
+    const PVLine& line = engine.getPrincipalVariation();
+    result.pv.assign(line.begin(), line.end());
+    return result;
+}
+
+ResultCache::ResultCache(size_t capacity, int shardCount) : hits(0), misses(0) {
+    if (shardCount < 1) shardCount = 1;
+    // Small caches get fewer shards so every shard can hold something
+    if (capacity > 0 && capacity < static_cast<size_t>(shardCount)) {
+        shardCount = static_cast<int>(capacity);
+    }
+    capacityPerShard = capacity / static_cast<size_t>(shardCount);
+
+    for (int i = 0; i < shardCount; i++) {
+        std::unique_ptr<Shard> shard(new Shard());
+        shard->slots.reserve(capacityPerShard);
+        shards.push_back(std::move(shard));
+    }
+}
+
+bool ResultCache::lookup(uint64_t key, int minDepth, CachedResult& result) {
+    if (!enabled()) return false;
+
+    Shard& shard = shardFor(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            Slot& slot = shard.slots[it->second];
+            if (slot.result.depth >= minDepth) {
+                slot.referenced = true;
+                result = slot.result;
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void ResultCache::store(uint64_t key, const CachedResult& result) {
+    if (!enabled()) return;
+
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        Slot& slot = shard.slots[it->second];
+        if (result.depth >= slot.result.depth) {
+            slot.result = result;
+        }
+        slot.referenced = true;
+        return;
+    }
+
+    size_t position;
+    if (shard.slots.size() < capacityPerShard) {
+        position = shard.slots.size();
+        shard.slots.emplace_back();
+    } else {
+        // CLOCK: give every recently used slot a second chance, take the first one that is not
+        while (shard.slots[shard.hand].referenced) {
+            shard.slots[shard.hand].referenced = false;
+            shard.hand = (shard.hand + 1) % capacityPerShard;
+        }
+        position = shard.hand;
+        shard.hand = (shard.hand + 1) % capacityPerShard;
+        shard.index.erase(shard.slots[position].key);
+    }
+
+    Slot& slot = shard.slots[position];
+    slot.key = key;
+    slot.result = result;
+    slot.referenced = false;
+    shard.index[key] = position;
+}
+
+void ResultCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->slots.clear();
+        shard->index.clear();
+        shard->hand = 0;
+    }
+}
+
+size_t ResultCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->index.size();
+    }
+    return total;
+}
@@ -0,0 +1,73 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "common.h"
+#include "piece.h"
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+// Outcome of a finished depth-limited search
+struct CachedResult
+{
+    Move move;            // Null when the side to move has no legal moves
+    int eval = 0;         // Centipawns, white's point of view
+    int depth = 0;        // Completed search depth
+    std::vector<Move> pv;
+
+    // What the search that just ran on engine found; positions without legal
+    // moves count as searched to any depth
+    static CachedResult fromSearch(const Engine &engine, const Move &bestMove);
+};
+
+// Bounded cache of search results in front of the engine, keyed by the
+// position's Zobrist key. A result searched to depth d also answers requests
+// for any depth up to d. Entries are spread over independently locked shards
+// so concurrent requests rarely wait on each other, and each shard evicts with
+// the CLOCK algorithm (a cheap approximation of LRU).
+class ResultCache
+{
+public:
+    // capacity is the total number of positions kept (0 disables the cache)
+    explicit ResultCache(size_t capacity, int shards = 16);
+
+    // A result for the position searched to at least minDepth; false if there is none
+    bool lookup(uint64_t key, int minDepth, CachedResult &result);
+
+    // Remember a result; a shallower result never replaces a deeper one
+    void store(uint64_t key, const CachedResult &result);
+
+    void clear();
+
+    bool enabled() const { return capacityPerShard > 0; }
+    size_t size() const;
+    size_t capacity() const { return capacityPerShard * shards.size(); }
+    long getHits() const { return hits.load(std::memory_order_relaxed); }
+    long getMisses() const { return misses.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        uint64_t key = 0;
+        CachedResult result;
+        bool referenced = false; // Used since the clock hand last passed
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::vector<Slot> slots;                   // Filled up to capacityPerShard, then recycled
+        std::unordered_map<uint64_t, size_t> index; // key -> slot
+        size_t hand = 0;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t capacityPerShard;
+    std::atomic<long> hits;
+    std::atomic<long> misses;
+
+    // The map hashes the low bits of the key, so shards are picked by the high ones
+    Shard &shardFor(uint64_t key) { return *shards[(key >> 40) % shards.size()]; }
+};
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,98 @@
+// Multi-connection HTTP front end for the engine (POSIX).
+//
+// Usage: chess_server [--port N] [--workers N] [--queue N] [--hash MB]
+//                     [--shared-tt] [--depth N] [--max-depth N] [--cache N]
+//                     [--batch-threads N] [--hash-file PATH]
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <csignal>
+#include <cstdlib>
+#include "http_server.h"
+#include "engine_service.h"
+
+namespace {
+
+HttpServer* activeServer = nullptr;
+
+void handleSignal(int) {
+    if (activeServer) activeServer->stop();
+}
+
+void printUsage() {
+    std::cout << "Usage: chess_server [--port N] [--workers N] [--queue N] [--hash MB]"
+              << " [--shared-tt] [--depth N] [--max-depth N] [--cache N] [--batch-threads N]"
+              << " [--hash-file PATH]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    HttpServer::Config serverConfig;
+    EngineService::Options engineOptions;
+
+    unsigned cores = std::thread::hardware_concurrency();
+    serverConfig.workers = cores > 0 ? static_cast<int>(cores) : 1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (arg == "--shared-tt") {
+            engineOptions.sharedTT = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        if (arg == "--hash-file") {
+            engineOptions.hashFile = argv[++i];
+            continue;
+        }
+        int value = std::atoi(argv[++i]);
+        if (arg == "--port") serverConfig.port = value;
+        else if (arg == "--workers") serverConfig.workers = std::max(1, value);
+        else if (arg == "--queue") serverConfig.queueCapacity = static_cast<size_t>(std::max(1, value));
+        else if (arg == "--hash") engineOptions.ttSizeMB = std::max(1, value);
+        else if (arg == "--depth") engineOptions.defaultDepth = std::max(1, value);
+        else if (arg == "--max-depth") engineOptions.maxDepth = std::max(1, value);
+        else if (arg == "--cache") engineOptions.cacheEntries = static_cast<size_t>(std::max(0, value));
+        else if (arg == "--batch-threads") engineOptions.batchThreads = std::max(1, value);
+        else {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    engineOptions.workers = serverConfig.workers;
+    EngineService service(engineOptions);
+
+    {
+        HttpServer server(serverConfig);
+        service.registerRoutes(server);
+        if (!server.start()) {
+            return 1;
+        }
+
+        activeServer = &server;
+        std::signal(SIGINT, handleSignal);
+        std::signal(SIGTERM, handleSignal);
+        std::signal(SIGPIPE, SIG_IGN);
+
+        std::cout << "Engine server listening on port " << serverConfig.port
+                  << " (" << serverConfig.workers << " workers, queue " << serverConfig.queueCapacity << ")" << std::endl;
+
+        server.run();
+        activeServer = nullptr;
+    } // The server joins its workers here, so no search is using the table any more
+
+    service.saveHash();
+    std::cout << "Engine server stopped" << std::endl;
+    return 0;
+}
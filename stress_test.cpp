@@ -0,0 +1,107 @@
+// Search stress harness: reaches random positions by random playouts, pushes
+// them through FEN and runs a short search on each. Built with AddressSanitizer
+// and UBSan (see CMakeLists.txt), so any memory error or undefined behaviour in
+// move generation, make/unmake or the search aborts the run.
+//
+// Usage: stress_test [searches] [seed]
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <random>
+#include <cstdlib>
+#include "game.h"
+#include "engine.h"
+
+namespace {
+
+const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// Well-known positions with castling, en passant and promotion edge cases
+const char* SEED_FENS[] = {
+    START_FEN,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+// Play up to maxPlies random legal moves from a seed position
+std::string randomPosition(std::mt19937& rng, int maxPlies) {
+    std::uniform_int_distribution<int> seedPick(0, static_cast<int>(sizeof(SEED_FENS) / sizeof(SEED_FENS[0])) - 1);
+    Board board;
+    board.setupFromFEN(SEED_FENS[seedPick(rng)]);
+
+    int plies = std::uniform_int_distribution<int>(0, maxPlies)(rng);
+    for (int i = 0; i < plies; i++) {
+        MoveList moves = board.generateLegalMoves();
+        if (moves.empty()) break;
+        Move move = moves[std::uniform_int_distribution<int>(0, static_cast<int>(moves.size()) - 1)(rng)];
+        board.makeMove(move);
+    }
+    return board.toFEN();
+}
+
+bool isLegal(const Board& board, const Move& move) {
+    MoveList moves = board.generateLegalMoves();
+    for (const auto& legal : moves) {
+        if (legal.sameAs(move)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int searches = argc > 1 ? std::atoi(argv[1]) : 2000;
+    unsigned seed = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 12345u;
+    std::mt19937 rng(seed);
+
+    Game game;
+    Engine engine(game, 4, 16);
+
+    // The search logs every iteration; keep the harness output readable
+    std::ostringstream discard;
+    std::streambuf* console = std::cout.rdbuf();
+
+    int failures = 0;
+    for (int i = 0; i < searches; i++) {
+        std::string fen = randomPosition(rng, 120);
+        int depth = std::uniform_int_distribution<int>(1, 6)(rng);
+
+        game.newGameFromFEN(fen);
+        engine.setDepth(depth);
+        engine.setNodeLimit(4000);
+        if (i % 50 == 0) engine.clearTT();
+
+        std::cout.rdbuf(discard.rdbuf());
+        Move best = engine.getBestMove();
+        std::cout.rdbuf(console);
+        discard.str("");
+
+        const Board& board = game.getBoard();
+        bool hasMoves = !board.generateLegalMoves().empty();
+
+        if (hasMoves && (best.isNull() || !isLegal(board, best))) {
+            std::cerr << "FAIL: illegal best move " << best.toString() << " (depth " << depth << ") in " << fen << std::endl;
+            failures++;
+        } else if (!hasMoves && !best.isNull()) {
+            std::cerr << "FAIL: move " << best.toString() << " returned in a terminal position " << fen << std::endl;
+            failures++;
+        }
+
+        // The search must leave the game position exactly as it found it
+        if (board.toFEN() != fen || board.getHashKey() != Zobrist::generateHashKey(board)) {
+            std::cerr << "FAIL: position changed by the search: " << fen << " -> " << board.toFEN() << std::endl;
+            failures++;
+        }
+
+        if ((i + 1) % 100 == 0) {
+            std::cout << (i + 1) << "/" << searches << " searches, " << failures << " failures" << std::endl;
+        }
+    }
+
+    std::cout << "Stress test finished: " << searches << " searches, " << failures << " failures" << std::endl;
+    return failures == 0 ? 0 : 1;
+}
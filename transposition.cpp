@@ -1,110 +1,325 @@
 #include "transposition.h"
+#include "zobrist.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <new>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
-TranspositionTable::TranspositionTable(int sizeMB) {
-    currentAge = 0;
-    resize(sizeMB);
+static_assert(sizeof(TTSlot) == 16, "TT slots must stay 16 bytes");
+static_assert(sizeof(TTCluster) == 64, "A TT cluster must fill exactly one cache line");
+
+static_assert(TT_FILE_HEADER_BYTES >= sizeof(TTFileHeader), "TT snapshot header does not fit its padding");
+
+static const size_t HUGE_PAGE_BYTES = 2 * 1024 * 1024;
+
+// Below this many bytes per thread, starting threads costs more than it saves
+static const size_t CLEAR_BYTES_PER_THREAD = 32 * 1024 * 1024;
+
+// Spread a fresh, untouched mapping over all online NUMA nodes so that no
+// node's memory controller serves every probe. Returns the number of nodes.
+static int interleaveAcrossNodes(void* memory, size_t bytes) {
+#if defined(__linux__) && defined(SYS_mbind)
+    // The online node list looks like "0", "0-1" or "0,2-3"
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string list;
+    if (!std::getline(online, list)) return 1;
+
+    unsigned long mask = 0;
+    int nodes = 0;
+    std::istringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        int first = 0;
+        int last = 0;
+        if (std::sscanf(range.c_str(), "%d-%d", &first, &last) < 2) last = first;
+        for (int node = first; node <= last && node < 64; node++) {
+            mask |= 1UL << node;
+            nodes++;
+        }
+    }
+    if (nodes < 2) return 1;
+
+    const int MPOL_INTERLEAVE_MODE = 3; // MPOL_INTERLEAVE from <numaif.h>
+    if (syscall(SYS_mbind, memory, bytes, MPOL_INTERLEAVE_MODE, &mask, sizeof(mask) * 8 + 1, 0) != 0) {
+        return 1;
+    }
+    return nodes;
+#else
+    (void)memory;
+    (void)bytes;
+    return 1;
+#endif
+}
+
+TranspositionTable::TranspositionTable(int sizeMB)
+    : table(nullptr), mapping(nullptr), mappingBytes(0), clusterCount(0), clusterMask(0), currentAge(0),
+      numaNodes(1), lastResizeMs(0) {
+    if (!resize(sizeMB)) {
+        throw std::bad_alloc();
+    }
+}
+
+TranspositionTable::~TranspositionTable() {
+    releaseTable();
 }
 
-void TranspositionTable::resize(int sizeMB) {
-    // Calculate number of entries
-    // Each entry is typically around 16-24 bytes, let's say 20 bytes average
-    size_t numEntries = (sizeMB * 1024 * 1024) / sizeof(TTEntry);
-    
-    // Make it a power of 2 (helps with modulo operations)
+void TranspositionTable::releaseTable() {
+#ifndef _WIN32
+    if (mapping) {
+        munmap(mapping, mappingBytes);
+    }
+#endif
+    mapping = nullptr;
+    mappingBytes = 0;
+    ownedTable.reset();
+    table = nullptr;
+    numaNodes = 1;
+}
+
+void TranspositionTable::allocate(size_t bytes) {
+#ifndef _WIN32
+    size_t rounded = (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+
+#ifdef MAP_HUGETLB
+    // Explicit huge pages only exist if the administrator reserved some
+    void* memory = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memory != MAP_FAILED) {
+        mapping = memory;
+        mappingBytes = rounded;
+        backing = "huge pages";
+    }
+#endif
+
+    if (!mapping) {
+        // Ordinary pages, aligned to 2 MB so transparent huge pages can back
+        // all of the table: map one huge page extra and trim both ends
+        size_t padded = rounded + HUGE_PAGE_BYTES;
+        void* memory = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        uintptr_t start = reinterpret_cast<uintptr_t>(memory);
+        uintptr_t aligned = (start + HUGE_PAGE_BYTES - 1) & ~static_cast<uintptr_t>(HUGE_PAGE_BYTES - 1);
+        if (aligned > start) {
+            munmap(memory, aligned - start);
+        }
+        if (aligned + rounded < start + padded) {
+            munmap(reinterpret_cast<void*>(aligned + rounded), start + padded - (aligned + rounded));
+        }
+        mapping = reinterpret_cast<void*>(aligned);
+        mappingBytes = rounded;
+        backing = "normal pages";
+#ifdef MADV_HUGEPAGE
+        if (madvise(mapping, mappingBytes, MADV_HUGEPAGE) == 0) {
+            backing = "transparent huge pages";
+        }
+#endif
+    }
+
+    numaNodes = interleaveAcrossNodes(mapping, mappingBytes);
+    table = static_cast<TTCluster*>(mapping);
+#else
+    ownedTable.reset(new TTCluster[bytes / sizeof(TTCluster)]);
+    table = ownedTable.get();
+    backing = "normal pages";
+#endif
+}
+
+bool TranspositionTable::resize(int sizeMB) {
+    auto start = std::chrono::steady_clock::now();
+    size_t numClusters = (static_cast<size_t>(sizeMB) * 1024 * 1024) / sizeof(TTCluster);
+
+    // Round down to a power of 2 so the index is a simple mask
     size_t powerOf2 = 1;
-    while (powerOf2 < numEntries) {
+    while (powerOf2 * 2 <= numClusters) {
         powerOf2 *= 2;
     }
-    powerOf2 /= 2; // Ensure we don't exceed the requested size
-    
-    size = powerOf2;
-    table.resize(size);
+
+    // Build the new table before letting go of the old one, so that a failed
+    // allocation leaves the search with the table it had
+    TTCluster* oldTable = table;
+    void* oldMapping = mapping;
+    size_t oldMappingBytes = mappingBytes;
+    std::unique_ptr<TTCluster[]> oldOwnedTable = std::move(ownedTable);
+    std::string oldBacking = backing;
+    int oldNumaNodes = numaNodes;
+
+    table = nullptr;
+    mapping = nullptr;
+    mappingBytes = 0;
+    try {
+        allocate(powerOf2 * sizeof(TTCluster));
+    } catch (const std::bad_alloc&) {
+        table = oldTable;
+        mapping = oldMapping;
+        mappingBytes = oldMappingBytes;
+        ownedTable = std::move(oldOwnedTable);
+        backing = oldBacking;
+        numaNodes = oldNumaNodes;
+        std::cerr << "Error: cannot allocate a " << sizeMB << " MB transposition table" << std::endl;
+        return false;
+    }
+
+#ifndef _WIN32
+    if (oldMapping) {
+        munmap(oldMapping, oldMappingBytes);
+    }
+#endif
+    oldOwnedTable.reset();
+    clusterCount = powerOf2;
+    clusterMask = clusterCount - 1;
+
+    // Fresh mappings are already zero, but clearing now faults every page in
+    // up front (spread over the clearing threads) instead of during the search
     clear();
+    lastResizeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
 }
 
-// REPLACE the entire store() method in transposition.cpp with this:
-void TranspositionTable::store(uint64_t key, int depth, int score, NodeType type, const Move& bestMove) 
+uint64_t TranspositionTable::pack(int depth, int score, NodeType type, const Move& bestMove, int age) {
+    int clampedDepth = std::max(0, std::min(depth, 255));
+    int clampedScore = std::max(-SCORE_BIAS, std::min(score, SCORE_BIAS - 1));
+
+    return static_cast<uint64_t>(bestMove.raw()) |
+           (static_cast<uint64_t>(clampedScore + SCORE_BIAS) << 16) |
+           (static_cast<uint64_t>(clampedDepth) << 36) |
+           (static_cast<uint64_t>(static_cast<int>(type) + 1) << 44) |
+           (static_cast<uint64_t>(age & AGE_MASK) << 46);
+}
+
+TTEntry TranspositionTable::unpack(uint64_t key, uint64_t data) {
+    return TTEntry(key,
+                   static_cast<int>((data >> 36) & 0xFF),
+                   static_cast<int>((data >> 16) & 0xFFFFF) - SCORE_BIAS,
+                   static_cast<NodeType>(((data >> 44) & 3) - 1),
+                   Move::fromRaw(static_cast<uint16_t>(data & 0xFFFF)),
+                   static_cast<int>((data >> 46) & AGE_MASK));
+}
+
+bool TranspositionTable::read(const TTSlot& slot, uint64_t key, TTEntry& entry) {
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+
+    // Empty slot, a different position, or a torn write
+    if (data == 0 || (keyXorData ^ data) != key) {
+        return false;
+    }
+
+    entry = unpack(key, data);
+    return true;
+}
+
+void TranspositionTable::write(TTSlot& slot, uint64_t key, uint64_t data) {
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.keyXorData.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, NodeType type, const Move& bestMove)
 {
-    size_t idx = index(key);
-    TTEntry& entry = table[idx];
-    
-    // IMPROVED replacement strategy with multiple factors
-    
-    // 1. Always replace empty slots
-    if (entry.key == 0) {
-        entry = TTEntry(key, depth, score, type, bestMove, currentAge);
-        return;
-    }
-    
-    // 2. Always replace if same position (update with new info)
-    if (entry.key == key) {
-        // Only replace if new search is deeper or same depth with newer age
-        if (depth >= entry.depth || currentAge > entry.age) {
-            entry = TTEntry(key, depth, score, type, bestMove, currentAge);
+    TTCluster& cluster = table[index(key)];
+    int age = currentAge.load(std::memory_order_relaxed);
+
+    TTSlot* victim = nullptr;
+    int victimScore = 0;
+
+    for (TTSlot& slot : cluster.slots) {
+        // 1. Same position: update it in place
+        TTEntry existing;
+        if (read(slot, key, existing)) {
+            // Only replace if the new search is deeper, exact, or from a newer search
+            if (depth < existing.depth && type != NodeType::EXACT && existing.age == age) {
+                return;
+            }
+            // Keep the old best move rather than overwriting it with nothing
+            Move move = bestMove.isNull() ? existing.bestMove : bestMove;
+            write(slot, key, pack(depth, score, type, move, age));
+            return;
+        }
+
+        // 2. Empty slots are always taken
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if (data == 0) {
+            victim = &slot;
+            victimScore = INT32_MIN;
+            continue;
+        }
+
+        // 3. Otherwise replace the least valuable entry in the cluster
+        uint64_t slotKey = slot.keyXorData.load(std::memory_order_relaxed) ^ data;
+        int slotScore = calculateReplacementScore(unpack(slotKey, data), age);
+        if (!victim || slotScore < victimScore) {
+            victim = &slot;
+            victimScore = slotScore;
         }
-        return;
-    }
-    
-    // 3. Complex replacement decision for different positions
-    // Calculate replacement scores for old and new entries
-    int oldScore = calculateReplacementScore(entry, currentAge);
-    int newScore = calculateReplacementScore(TTEntry(key, depth, score, type, bestMove, currentAge), currentAge);
-    
-    // Replace if new entry scores higher
-    if (newScore > oldScore) {
-        entry = TTEntry(key, depth, score, type, bestMove, currentAge);
     }
+
+    write(*victim, key, pack(depth, score, type, bestMove, age));
 }
 
-// ADD this helper method to transposition.cpp:
 int TranspositionTable::calculateReplacementScore(const TTEntry& entry, int currentAge) const
 {
     int score = 0;
-    
+
     // Bonus for depth (deeper searches are more valuable)
     score += entry.depth * 100;
-    
-    // Penalty for age (older entries are less valuable)
-    int ageDiff = currentAge - entry.age;
+
+    // Penalty for age (older entries are less valuable); ages wrap at 64
+    int ageDiff = (currentAge - entry.age) & AGE_MASK;
     score -= ageDiff * 50;
-    
+
     // Bonus for exact scores (more valuable than bounds)
     if (entry.type == NodeType::EXACT) {
         score += 200;
     }
-    
+
     // Bonus for having a best move
-    if (entry.bestMove.from.isValid() && entry.bestMove.to.isValid()) {
+    if (!entry.bestMove.isNull()) {
         score += 150;
     }
-    
+
     return score;
 }
 
-bool TranspositionTable::probe(uint64_t key, int depth, int alpha, int beta, int& score, Move& bestMove) {
-    size_t idx = index(key);
-    TTEntry& entry = table[idx];
-    
-    // Check if we have a matching position
-    if (entry.key == key) {
+bool TranspositionTable::probe(uint64_t key, int depth, int alpha, int beta, int& score, Move& bestMove,
+                               bool exactDepth) {
+    const TTCluster& cluster = table[index(key)];
+
+    for (const TTSlot& slot : cluster.slots) {
+        TTEntry entry;
+        if (!read(slot, key, entry)) {
+            continue;
+        }
+
         // Always return the best move, even if we can't use the score
         bestMove = entry.bestMove;
-        
+
         // Only use the score if the depth is sufficient
-        if (entry.depth >= depth) {
+        if (exactDepth ? entry.depth == depth : entry.depth >= depth) {
             // Adjust the score based on the node type
             switch (entry.type) {
                 case NodeType::EXACT:
                     score = entry.score;
                     return true;
-                
+
                 case NodeType::ALPHA:
                     if (entry.score <= alpha) {
                         score = alpha;
                         return true;
                     }
                     break;
-                
+
                 case NodeType::BETA:
                     if (entry.score >= beta) {
                         score = beta;
@@ -113,14 +328,219 @@ bool TranspositionTable::probe(uint64_t key, int depth, int alpha, int beta, int
                     break;
             }
         }
+        return false;
     }
-    
+
     return false;
 }
 
+int TranspositionTable::hashfull() const {
+    // Sample the first 1000 slots, like other engines do
+    size_t sampleClusters = std::min<size_t>(clusterCount, 1000 / TTCluster::SLOTS);
+    int used = 0;
+    for (size_t i = 0; i < sampleClusters; i++) {
+        for (const TTSlot& slot : table[i].slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if (data != 0 && static_cast<int>((data >> 46) & AGE_MASK) == getAge()) {
+                used++;
+            }
+        }
+    }
+    size_t sampled = sampleClusters * TTCluster::SLOTS;
+    return sampled > 0 ? static_cast<int>(used * 1000 / sampled) : 0;
+}
+
 void TranspositionTable::clear() {
-    for (size_t i = 0; i < size; i++) {
-        table[i] = TTEntry();
+    auto clearRange = [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            for (TTSlot& slot : table[i].slots) {
+                slot.data.store(0, std::memory_order_relaxed);
+                slot.keyXorData.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    size_t bytes = clusterCount * sizeof(TTCluster);
+    size_t threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, std::max<size_t>(1, bytes / CLEAR_BYTES_PER_THREAD));
+
+    if (threadCount == 1) {
+        clearRange(0, clusterCount);
+    } else {
+        std::vector<std::thread> threads;
+        size_t chunk = (clusterCount + threadCount - 1) / threadCount;
+        for (size_t begin = 0; begin < clusterCount; begin += chunk) {
+            threads.emplace_back(clearRange, begin, std::min(begin + chunk, clusterCount));
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
     }
     currentAge = 0;
-}
\ No newline at end of file
+}
+
+double TranspositionTable::measureProbeLatencyNs(size_t probes) const {
+    uint64_t key = 0x2545F4914F6CDD1DULL;
+    uint64_t sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < probes; i++) {
+        uint64_t data = table[index(key)].slots[0].data.load(std::memory_order_relaxed);
+        // The next address depends on this load, so the reads cannot overlap
+        key = (key ^ data) * 0x9E3779B97F4A7C15ULL + i;
+        sink += data;
+    }
+    double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    // Keep the loop from being optimized away
+    if (sink == 1) std::cerr << "";
+    return probes > 0 ? elapsedNs / static_cast<double>(probes) : 0.0;
+}
+
+std::string TranspositionTable::describe() const {
+    std::ostringstream out;
+    out << (clusterCount * sizeof(TTCluster)) / (1024 * 1024) << " MB, " << backing;
+    if (numaNodes > 1) {
+        out << ", interleaved over " << numaNodes << " NUMA nodes";
+    }
+    out << ", resized in " << static_cast<long>(lastResizeMs) << " ms";
+    return out.str();
+}
+
+uint64_t TranspositionTable::zobristCheck() {
+    return Zobrist::pieceKey(Color::WHITE, PieceType::PAWN, 8) ^
+           Zobrist::pieceKey(Color::BLACK, PieceType::KING, 60) ^
+           Zobrist::sideToMoveKey() ^
+           Zobrist::castlingKey(15) ^
+           Zobrist::enPassantKey(7);
+}
+
+bool TranspositionTable::save(const std::string& path) const {
+    TTFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TT_FILE_MAGIC, sizeof(header.magic));
+    header.version = TT_FILE_VERSION;
+    header.clusterBytes = sizeof(TTCluster);
+    header.slotsPerCluster = TTCluster::SLOTS;
+    header.layout = LAYOUT;
+    header.zobristSeed = Zobrist::SEED;
+    header.zobristCheck = zobristCheck();
+    header.clusterCount = clusterCount;
+    header.age = static_cast<uint32_t>(getAge());
+
+    // Write to a temporary name first so a failed save never clobbers a good snapshot
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: cannot write TT snapshot " << tempPath << std::endl;
+        return false;
+    }
+
+    char padding[TT_FILE_HEADER_BYTES] = {};
+    std::memcpy(padding, &header, sizeof(header));
+    bool ok = std::fwrite(padding, 1, sizeof(padding), file) == sizeof(padding) &&
+              std::fwrite(table, sizeof(TTCluster), clusterCount, file) == clusterCount;
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: writing TT snapshot " << path << " failed" << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Size of an open file in bytes. ftell returns a long, which is 32 bits on
+// Windows, so snapshots of 2 GB and more need the 64-bit calls.
+static bool fileSize(FILE* file, uint64_t& bytes) {
+#ifdef _WIN32
+    if (_fseeki64(file, 0, SEEK_END) != 0) return false;
+    __int64 end = _ftelli64(file);
+    if (end < 0) return false;
+    bytes = static_cast<uint64_t>(end);
+#else
+    struct stat info;
+    if (fstat(fileno(file), &info) != 0) return false;
+    bytes = static_cast<uint64_t>(info.st_size);
+#endif
+    return true;
+}
+
+bool TranspositionTable::load(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Error: cannot open TT snapshot " << path << std::endl;
+        return false;
+    }
+
+    TTFileHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1) {
+        std::cerr << "Error: " << path << " is too short to be a TT snapshot" << std::endl;
+        std::fclose(file);
+        return false;
+    }
+
+    const char* problem = nullptr;
+    if (std::memcmp(header.magic, TT_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        problem = "not a TT snapshot";
+    } else if (header.version != TT_FILE_VERSION) {
+        problem = "unsupported snapshot version";
+    } else if (header.clusterBytes != sizeof(TTCluster) || header.slotsPerCluster != TTCluster::SLOTS ||
+               header.layout != LAYOUT) {
+        problem = "written with a different entry layout";
+    } else if (header.zobristSeed != Zobrist::SEED || header.zobristCheck != zobristCheck()) {
+        problem = "written with different Zobrist keys";
+    } else if (header.clusterCount == 0 || (header.clusterCount & (header.clusterCount - 1)) != 0) {
+        problem = "invalid table size";
+    }
+
+    size_t dataBytes = static_cast<size_t>(header.clusterCount) * sizeof(TTCluster);
+    if (!problem) {
+        uint64_t fileBytes = 0;
+        if (!fileSize(file, fileBytes) || fileBytes != TT_FILE_HEADER_BYTES + dataBytes) {
+            problem = "truncated or oversized file";
+        }
+    }
+    if (problem) {
+        std::cerr << "Error: cannot load " << path << ": " << problem << std::endl;
+        std::fclose(file);
+        return false;
+    }
+
+#ifndef _WIN32
+    // Map the whole file privately: nothing is read until a probe touches a
+    // page, and stores go to private copies of the pages, never to the file
+    size_t totalBytes = TT_FILE_HEADER_BYTES + dataBytes;
+    void* view = mmap(nullptr, totalBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(file), 0);
+    std::fclose(file);
+    if (view == MAP_FAILED) {
+        std::cerr << "Error: cannot map TT snapshot " << path << std::endl;
+        return false;
+    }
+
+    releaseTable();
+    mapping = view;
+    mappingBytes = totalBytes;
+    backing = "snapshot file mapping";
+    table = reinterpret_cast<TTCluster*>(static_cast<char*>(view) + TT_FILE_HEADER_BYTES);
+#else
+    std::unique_ptr<TTCluster[]> loaded(new TTCluster[header.clusterCount]);
+    _fseeki64(file, static_cast<__int64>(TT_FILE_HEADER_BYTES), SEEK_SET);
+    bool ok = std::fread(loaded.get(), sizeof(TTCluster), header.clusterCount, file) == header.clusterCount;
+    std::fclose(file);
+    if (!ok) {
+        std::cerr << "Error: reading TT snapshot " << path << " failed" << std::endl;
+        return false;
+    }
+
+    releaseTable();
+    ownedTable = std::move(loaded);
+    table = ownedTable.get();
+    backing = "snapshot file copy";
+#endif
+
+    clusterCount = static_cast<size_t>(header.clusterCount);
+    clusterMask = clusterCount - 1;
+    currentAge.store(static_cast<int>(header.age) & AGE_MASK, std::memory_order_relaxed);
+    return true;
+}
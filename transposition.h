@@ -3,6 +3,7 @@
 
 #include "common.h"
 #include "piece.h"
+#include <atomic>
 
 // Node types for transposition table entries
 enum class NodeType
@@ -12,7 +13,7 @@ enum class NodeType
     BETA   // Lower bound (fail-high)
 };
 
-// Structure for transposition table entries
+// Decoded transposition table entry
 struct TTEntry
 {
     uint64_t key;  // Zobrist hash key
@@ -22,47 +23,155 @@ struct TTEntry
     Move bestMove; // Best move from this position
     int age;       // Age of the entry (for replacement strategy)
 
-    TTEntry() : key(0), depth(0), score(0), type(NodeType::EXACT), bestMove(Position(), Position()), age(0) {}
+    TTEntry() : key(0), depth(0), score(0), type(NodeType::EXACT), bestMove(), age(0) {}
 
     TTEntry(uint64_t k, int d, int s, NodeType t, Move bm, int a)
         : key(k), depth(d), score(s), type(t), bestMove(bm), age(a) {}
 };
 
+// One 16-byte slot as stored in memory. All fields are packed into one word:
+//
+//   bits  0-15  best move (Move::raw)
+//   bits 16-35  score, offset by SCORE_BIAS
+//   bits 36-43  depth (clamped to 0-255)
+//   bits 44-45  node type + 1 (0 marks an empty slot)
+//   bits 46-51  age (search generation, modulo 64)
+//
+// The key is stored XORed with the data word. A reader recomputes
+// keyXorData ^ data and only accepts the slot if it equals the probed key, so
+// a slot torn by two threads writing at once just reads as a miss. Both words
+// are relaxed atomics, which compile to plain loads and stores on x86.
+struct TTSlot
+{
+    std::atomic<uint64_t> keyXorData;
+    std::atomic<uint64_t> data;
+};
+
+// Four slots per cache line; a probe touches exactly one line
+struct alignas(64) TTCluster
+{
+    static const int SLOTS = 4;
+    TTSlot slots[SLOTS];
+};
+
+// Snapshot file layout: this header, zero-padded to TT_FILE_HEADER_BYTES so
+// the clusters that follow start on a page boundary and can be mapped in
+// place, then clusterCount raw TTClusters. Everything that decides whether
+// the stored words still mean the same thing is recorded and checked on load.
+struct TTFileHeader
+{
+    char magic[8];             // TT_FILE_MAGIC
+    uint32_t version;          // TT_FILE_VERSION
+    uint32_t clusterBytes;     // sizeof(TTCluster)
+    uint32_t slotsPerCluster;  // TTCluster::SLOTS
+    uint32_t layout;           // TranspositionTable::LAYOUT, the packing of a slot's data word
+    uint64_t zobristSeed;      // Zobrist::SEED
+    uint64_t zobristCheck;     // A few Zobrist keys folded together, in case key generation changes
+    uint64_t clusterCount;
+    uint32_t age;              // Search generation when the snapshot was taken
+    uint32_t reserved;
+};
+
+static const char TT_FILE_MAGIC[8] = {'C', 'E', 'T', 'T', 'S', 'N', 'A', 'P'};
+static const uint32_t TT_FILE_VERSION = 1;
+static const size_t TT_FILE_HEADER_BYTES = 4096;
+
 class TranspositionTable
 {
 private:
-    std::vector<TTEntry> table;
-    size_t size;
-    int currentAge;
+    TTCluster *table;                        // clusterCount clusters
+    std::unique_ptr<TTCluster[]> ownedTable; // Backs table where mmap is not available
+    void *mapping;                           // Anonymous memory or a snapshot file, mapped
+    size_t mappingBytes;
+    size_t clusterCount;
+    size_t clusterMask;
+    std::atomic<int> currentAge; // Engines sharing one table all bump it
     int calculateReplacementScore(const TTEntry &entry, int currentAge) const;
 
+    static const int SCORE_BIAS = 1 << 19;
+    static const int AGE_MASK = 63;
+
+    // Bumped whenever pack()/unpack() change, so old snapshots are rejected
+    static const uint32_t LAYOUT = 1;
+
+    // How the table is backed and how long the last resize took, for reports
+    std::string backing;
+    int numaNodes;
+    double lastResizeMs;
+
+    static uint64_t zobristCheck();
+    void allocate(size_t bytes);
+    void releaseTable();
+
+    static uint64_t pack(int depth, int score, NodeType type, const Move &bestMove, int age);
+    static TTEntry unpack(uint64_t key, uint64_t data);
+
+    // Read one slot; false if it is empty or belongs to another key
+    static bool read(const TTSlot &slot, uint64_t key, TTEntry &entry);
+    static void write(TTSlot &slot, uint64_t key, uint64_t data);
+
 public:
-    // Constructor with table size (power of 2)
+    // Constructor with table size in megabytes
     TranspositionTable(int sizeMB = 64);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
 
-    // Resize the table
-    void resize(int sizeMB);
+    // Resize the table (rounded down to a power-of-two number of clusters).
+    // Where the system allows, the memory comes from 2 MB huge pages (explicit
+    // MAP_HUGETLB pages, else transparent huge pages) so that random probes do
+    // not thrash the TLB, and on multi-node machines it is interleaved across
+    // NUMA nodes. If the memory cannot be had, the old table is kept and false
+    // is returned.
+    bool resize(int sizeMB);
 
     // Store a position in the table
     void store(uint64_t key, int depth, int score, NodeType type, const Move &bestMove);
 
-    // Probe the table for a position
-    bool probe(uint64_t key, int depth, int alpha, int beta, int &score, Move &bestMove);
+    // Probe the table for a position. With exactDepth only an entry stored at
+    // exactly this depth can give a score; any other still gives its move.
+    bool probe(uint64_t key, int depth, int alpha, int beta, int &score, Move &bestMove,
+               bool exactDepth = false);
 
-    // Clear the table
+    // Clear the table; large tables are cleared by several threads at once
     void clear();
 
+    // Write the table to a snapshot file. Not safe while a search is running.
+    bool save(const std::string &path) const;
+
+    // Replace the table with a snapshot written by save(); the table takes the
+    // snapshot's size. On POSIX systems the file is mapped copy-on-write, so
+    // loading is immediate and pages are read in as probes touch them. On a
+    // bad or incompatible file the table is left as it was and false is
+    // returned. Not safe while a search is running.
+    bool load(const std::string &path);
+
     // Increment the age (typically done at the start of a new search)
-    void incrementAge() { currentAge++; }
+    void incrementAge() { currentAge.store((currentAge.load(std::memory_order_relaxed) + 1) & AGE_MASK, std::memory_order_relaxed); }
 
     // Get the current age
-    int getAge() const { return currentAge; }
+    int getAge() const { return currentAge.load(std::memory_order_relaxed); }
+
+    // Permille of sampled slots written during the current search (UCI hashfull)
+    int hashfull() const;
+
+    // Average time in nanoseconds of a probe's memory access: dependent reads
+    // of random clusters, so probes cannot overlap. Not during a search.
+    double measureProbeLatencyNs(size_t probes = 1 << 20) const;
+
+    // One line on size, page backing, NUMA placement and resize time
+    std::string describe() const;
+    double getLastResizeMs() const { return lastResizeMs; }
+
+    // Get table size in entries
+    size_t getSize() const { return clusterCount * TTCluster::SLOTS; }
 
-    // Get table size
-    size_t getSize() const { return size; }
+    // Pull the cluster for key into the cache ahead of a probe or store
+    void prefetch(uint64_t key) const { prefetchLine(&table[index(key)]); }
 
-    // Calculate the index in the table for a given key
-    size_t index(uint64_t key) const { return key % size; }
+    // Calculate the cluster index for a given key
+    size_t index(uint64_t key) const { return key & clusterMask; }
 };
 
-#endif // TRANSPOSITION_H
\ No newline at end of file
+#endif // TRANSPOSITION_H
@@ -5,14 +5,27 @@
 #include <thread>
 
 UCIProtocol::UCIProtocol(Game& g, Engine& e) 
-    : game(g), engine(e), debugMode(false), searchActive(false) {
+    : game(g), engine(e), debugMode(false), searchActive(false),
+      holdBestMove(false), ponderTimeMs(0), rootSideToMove(Color::WHITE) {
     initializeOptions();
+    engine.setSearchListener([this](const SearchInfo& info) { sendInfo(info); });
+}
+
+UCIProtocol::~UCIProtocol() {
+    stopSearch();
+    engine.setSearchListener(nullptr);
 }
 
 void UCIProtocol::initializeOptions() {
     // Hash table size (MB)
     options["Hash"] = UCIOption("Hash", UCIOptionType::SPIN, "64", "1", "2048");
     
+    // Pawn hash table size per search thread (MB)
+    options["PawnHash"] = UCIOption("PawnHash", UCIOptionType::SPIN, "2", "1", "256");
+    
+    // Search threads (Lazy SMP)
+    options["Threads"] = UCIOption("Threads", UCIOptionType::SPIN, "1", "1", "256");
+    
     // Search depth
     options["Depth"] = UCIOption("Depth", UCIOptionType::SPIN, "10", "1", "50");
     
@@ -31,6 +44,14 @@ void UCIProtocol::initializeOptions() {
     
     // Clear hash button
     options["Clear Hash"] = UCIOption("Clear Hash", UCIOptionType::BUTTON, "");
+    
+    // Transposition table snapshots (also the savehash/loadhash commands)
+    options["HashFile"] = UCIOption("HashFile", UCIOptionType::STRING, "hash.tt");
+    options["Save Hash"] = UCIOption("Save Hash", UCIOptionType::BUTTON, "");
+    options["Load Hash"] = UCIOption("Load Hash", UCIOptionType::BUTTON, "");
+    
+    // Keep the table across ucinewgame, e.g. after loading a snapshot for analysis
+    options["Keep Hash"] = UCIOption("Keep Hash", UCIOptionType::CHECK, "false");
 }
 
 void UCIProtocol::run() {
@@ -60,39 +81,49 @@ void UCIProtocol::processCommand(const std::string& command) {
         handleGo(command);
     } else if (cmd == "stop") {
         handleStop();
+    } else if (cmd == "ponderhit") {
+        handlePonderHit();
     } else if (cmd == "setoption") {
         handleSetOption(command);
+    } else if (cmd == "savehash" || cmd == "loadhash") {
+        std::string path;
+        std::getline(iss >> std::ws, path);
+        handleHashFile(cmd == "savehash", path.empty() ? getOption("HashFile") : path);
     } else if (cmd == "quit") {
         handleQuit();
     } else if (debugMode) {
-        std::cout << "info string Unknown command: " << command << std::endl;
+        send("info string Unknown command: " + command);
     }
 }
 
 void UCIProtocol::handleUCI() {
     // Send engine identification
-    std::cout << "id name YourChessEngine 1.0" << std::endl;
-    std::cout << "id author YourName" << std::endl;
+    send("id name YourChessEngine 1.0");
+    send("id author YourName");
     
     // Send all options
     for (const auto& [name, option] : options) {
         sendOption(option);
     }
     
-    std::cout << "uciok" << std::endl;
+    send("uciok");
 }
 
 void UCIProtocol::handleIsReady() {
-    std::cout << "readyok" << std::endl;
+    send("readyok");
 }
 
 void UCIProtocol::handleUCINewGame() {
+    stopSearch();
+    
     // Clear hash tables and reset engine state
-    engine.clearTT();
+    if (getOption("Keep Hash") != "true") {
+        engine.clearTT();
+    }
     game.newGame();
     
     if (debugMode) {
-        std::cout << "info string New game started" << std::endl;
+        send("info string New game started");
     }
 }
 
@@ -101,6 +132,9 @@ void UCIProtocol::handlePosition(const std::string& command) {
     
     if (tokens.size() < 2) return;
     
+    // Never change the position under a running search
+    stopSearch();
+    
     if (tokens[1] == "startpos") {
         game.newGame();
         
@@ -111,7 +145,7 @@ void UCIProtocol::handlePosition(const std::string& command) {
             for (auto it = movesIt + 1; it != tokens.end(); ++it) {
                 if (!game.makeMove(*it)) {
                     if (debugMode) {
-                        std::cout << "info string Invalid move: " << *it << std::endl;
+                        send("info string Invalid move: " + *it);
                     }
                     return;
                 }
@@ -130,7 +164,7 @@ void UCIProtocol::handlePosition(const std::string& command) {
             for (auto it = movesIt + 1; it != tokens.end(); ++it) {
                 if (!game.makeMove(*it)) {
                     if (debugMode) {
-                        std::cout << "info string Invalid move: " << *it << std::endl;
+                        send("info string Invalid move: " + *it);
                     }
                     return;
                 }
@@ -140,19 +174,26 @@ void UCIProtocol::handlePosition(const std::string& command) {
 }
 
 void UCIProtocol::handleGo(const std::string& command) {
-    std::vector<std::string> tokens = split(command, ' ');
+    // A go while still searching: finish the old search first
+    stopSearch();
     
-    searchActive = true;
+    std::vector<std::string> tokens = split(command, ' ');
     
     // Parse go command parameters
     int depth = std::stoi(getOption("Depth"));
+    bool depthGiven = false;
     int moveTime = 0;
     int wtime = 0, btime = 0, winc = 0, binc = 0;
+    int movesToGo = 0;
+    int mate = 0;
+    long nodes = 0;
     bool infinite = false;
+    bool ponder = false;
     
     for (size_t i = 1; i < tokens.size(); i++) {
         if (tokens[i] == "depth" && i + 1 < tokens.size()) {
             depth = std::stoi(tokens[i + 1]);
+            depthGiven = true;
             i++;
         } else if (tokens[i] == "movetime" && i + 1 < tokens.size()) {
             moveTime = std::stoi(tokens[i + 1]);
@@ -169,63 +210,138 @@ void UCIProtocol::handleGo(const std::string& command) {
         } else if (tokens[i] == "binc" && i + 1 < tokens.size()) {
             binc = std::stoi(tokens[i + 1]);
             i++;
+        } else if (tokens[i] == "movestogo" && i + 1 < tokens.size()) {
+            movesToGo = std::stoi(tokens[i + 1]);
+            i++;
+        } else if (tokens[i] == "nodes" && i + 1 < tokens.size()) {
+            nodes = std::stol(tokens[i + 1]);
+            i++;
+        } else if (tokens[i] == "mate" && i + 1 < tokens.size()) {
+            mate = std::stoi(tokens[i + 1]);
+            i++;
         } else if (tokens[i] == "infinite") {
             infinite = true;
+        } else if (tokens[i] == "ponder") {
+            ponder = true;
         }
     }
     
+    // Unbounded searches run until stopped; mate searches need 2N-1 plies
+    if ((infinite || ponder) && !depthGiven) {
+        depth = MAX_PLY - 1;
+    } else if (mate > 0 && !depthGiven) {
+        depth = 2 * mate - 1;
+    }
+    
     // Set engine parameters
+    engine.clearSearchLimits();
     engine.setDepth(depth);
+    engine.setNodeLimit(nodes);
+    engine.setMateLimit(mate);
     
     // Calculate time allocation if needed
+    int allocatedTime = 0;
     if (moveTime > 0) {
-        engine.setTimeForMove(moveTime);
+        allocatedTime = moveTime;
     } else if (wtime > 0 || btime > 0) {
         // Simple time management
         Color sideToMove = game.getBoard().getSideToMove();
         int timeLeft = (sideToMove == Color::WHITE) ? wtime : btime;
         int increment = (sideToMove == Color::WHITE) ? winc : binc;
         
-        // Allocate roughly 1/30th of remaining time plus increment
-        int allocatedTime = (timeLeft / 30) + increment;
+        // Spread the remaining time over the moves to the next control,
+        // or roughly 1/30th of it in sudden death, plus the increment
+        int movesLeft = (movesToGo > 0) ? movesToGo : 30;
+        allocatedTime = (timeLeft / movesLeft) + increment;
         allocatedTime = std::max(100, std::min(allocatedTime, timeLeft / 2));
-        
-        engine.setTimeForMove(allocatedTime);
     }
     
-    // Start search in a separate thread (for real implementation)
-    // For now, we'll do it synchronously
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    Move bestMove = engine.getBestMove();
+    // While pondering the clock is not ours yet; the budget starts at ponderhit
+    if (allocatedTime > 0 && !infinite && !ponder) {
+        engine.setTimeForMove(allocatedTime);
+    }
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        holdBestMove = infinite || ponder;
+        ponderTimeMs = ponder ? allocatedTime : 0;
+    }
+    rootSideToMove = game.getBoard().getSideToMove();
+    goStartTime = std::chrono::steady_clock::now();
     
-sendInfo(depth, 0, engine.getNodesSearched(), static_cast<int>(duration.count()), engine.getPVString());
-
+    // Cleared here rather than by the search itself, so a stop that arrives
+    // before the worker has started still stops it
+    engine.clearStop();
+    searchActive = true;
+    searchThread = std::thread(&UCIProtocol::searchWorker, this);
+}
 
+void UCIProtocol::searchWorker() {
+    Move bestMove = engine.getBestMove(true);
+    
+    // After go infinite/ponder the GUI expects bestmove only once it has sent
+    // stop or ponderhit, even if the search ran out of depth earlier
+    {
+        std::unique_lock<std::mutex> lock(stopMutex);
+        stopCondition.wait(lock, [this]() { return !holdBestMove; });
+    }
     
-    // Send best move
-    sendBestMove(bestMove);
+    const PVLine& pv = engine.getPrincipalVariation();
+    Move ponderMove = (pv.size() >= 2 && pv[0] == bestMove) ? pv[1] : Move();
+    sendBestMove(bestMove, ponderMove);
     
     searchActive = false;
 }
 
+void UCIProtocol::stopSearch() {
+    if (!searchThread.joinable()) return;
+    
+    engine.stop();
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        holdBestMove = false;
+    }
+    stopCondition.notify_all();
+    searchThread.join();
+}
+
 void UCIProtocol::handleStop() {
-    if (searchActive) {
-        // In a real implementation, this would signal the search thread to stop
-        searchActive = false;
+    if (searchThread.joinable()) {
+        stopSearch();
         
         if (debugMode) {
-            std::cout << "info string Search stopped" << std::endl;
+            send("info string Search stopped");
         }
     }
 }
 
+void UCIProtocol::handlePonderHit() {
+    if (!searchThread.joinable()) return;
+    
+    std::lock_guard<std::mutex> lock(stopMutex);
+    if (ponderTimeMs > 0) {
+        // Our clock started when the opponent played the pondered move,
+        // so the budget counts from now rather than from the original go
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - goStartTime).count();
+        engine.ponderHit(static_cast<int>(elapsed) + ponderTimeMs);
+    } else {
+        // Pondering without a clock: nothing to budget, answer right away
+        engine.stop();
+    }
+    holdBestMove = false;
+    stopCondition.notify_all();
+}
+
 void UCIProtocol::handleSetOption(const std::string& command) {
     std::vector<std::string> tokens = split(command, ' ');
     
+    // Buttons have no value: setoption name <name>
+    if (tokens.size() >= 3 && tokens[1] == "name" && command.find(" value ") == std::string::npos) {
+        updateOption(command.substr(command.find(" name ") + 6), "");
+        return;
+    }
+    
     // Format: setoption name <name> value <value>
     if (tokens.size() >= 5 && tokens[1] == "name" && tokens[3] == "value") {
         std::string optionName = tokens[2];
@@ -243,50 +359,87 @@ void UCIProtocol::handleSetOption(const std::string& command) {
     }
 }
 
+void UCIProtocol::handleHashFile(bool save, const std::string& path) {
+    // The table must not change under a running search
+    stopSearch();
+    
+    bool ok = save ? engine.saveTT(path) : engine.loadTT(path);
+    if (ok) {
+        send(std::string("info string ") + (save ? "Saved hash to " : "Loaded hash from ") + path +
+             " (" + std::to_string(engine.getTTSizeMB()) + " MB)");
+    } else {
+        send(std::string("info string ") + (save ? "Saving hash to " : "Loading hash from ") + path + " failed");
+    }
+}
+
 void UCIProtocol::handleQuit() {
+    stopSearch();
+    
     if (debugMode) {
-        std::cout << "info string Goodbye!" << std::endl;
+        send("info string Goodbye!");
     }
     exit(0);
 }
 
 void UCIProtocol::sendOption(const UCIOption& option) {
-    std::cout << "option name " << option.name << " type ";
+    std::ostringstream line;
+    line << "option name " << option.name << " type ";
     
     switch (option.type) {
         case UCIOptionType::CHECK:
-            std::cout << "check default " << option.defaultValue;
+            line << "check default " << option.defaultValue;
             break;
         case UCIOptionType::SPIN:
-            std::cout << "spin default " << option.defaultValue 
-                      << " min " << option.minValue 
-                      << " max " << option.maxValue;
+            line << "spin default " << option.defaultValue 
+                 << " min " << option.minValue 
+                 << " max " << option.maxValue;
             break;
         case UCIOptionType::COMBO:
-            std::cout << "combo default " << option.defaultValue;
+            line << "combo default " << option.defaultValue;
             for (const auto& val : option.comboValues) {
-                std::cout << " var " << val;
+                line << " var " << val;
             }
             break;
         case UCIOptionType::BUTTON:
-            std::cout << "button";
+            line << "button";
             break;
         case UCIOptionType::STRING:
-            std::cout << "string default " << option.defaultValue;
+            line << "string default " << option.defaultValue;
             break;
     }
     
-    std::cout << std::endl;
+    send(line.str());
 }
 
 void UCIProtocol::updateOption(const std::string& name, const std::string& value) {
     if (options.find(name) != options.end()) {
         options[name].currentValue = value;
-        
+
+        // These rebuild tables and helper engines the search threads are using
+        if (name == "Hash" || name == "PawnHash" || name == "Threads" || name == "Clear Hash") {
+            stopSearch();
+        }
+
         // Apply the option to the engine
         if (name == "Hash") {
             int hashSize = std::stoi(value);
-            engine.setTTSize(hashSize);
+            if (!engine.setTTSize(hashSize)) {
+                options[name].currentValue = std::to_string(engine.getTTSizeMB());
+                send("info string Hash " + value + " MB could not be allocated, keeping " +
+                     options[name].currentValue + " MB");
+                return;
+            }
+            const TranspositionTable& table = engine.getTranspositionTable();
+            std::ostringstream report;
+            report << "info string Hash " << table.describe() << ", probe "
+                   << static_cast<int>(table.measureProbeLatencyNs()) << " ns";
+            send(report.str());
+        } else if (name == "PawnHash") {
+            int pawnHashSize = std::stoi(value);
+            engine.setPawnHashSize(pawnHashSize);
+        } else if (name == "Threads") {
+            int threads = std::stoi(value);
+            engine.setThreads(threads);
         } else if (name == "Depth") {
             int depth = std::stoi(value);
             engine.setDepth(depth);
@@ -297,14 +450,16 @@ void UCIProtocol::updateOption(const std::string& name, const std::string& value
             debugMode = (value == "true");
         } else if (name == "Clear Hash") {
             engine.clearTT();
+        } else if (name == "Save Hash" || name == "Load Hash") {
+            handleHashFile(name == "Save Hash", getOption("HashFile"));
         }
         // Note: Evaluation weights would need engine modifications to be applied
         
         if (debugMode) {
-            std::cout << "info string Set " << name << " = " << value << std::endl;
+            send("info string Set " + name + " = " + value);
         }
     } else if (debugMode) {
-        std::cout << "info string Unknown option: " << name << std::endl;
+        send("info string Unknown option: " + name);
     }
 }
 
@@ -331,23 +486,55 @@ std::vector<std::string> UCIProtocol::split(const std::string& str, char delimit
     return tokens;
 }
 
-void UCIProtocol::sendBestMove(const Move& move) {
-    std::cout << "bestmove " << move.toString() << std::endl;
+void UCIProtocol::send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
 }
 
-void UCIProtocol::sendInfo(int depth, int score, long nodes, int time, const std::string& pv) {
-    std::cout << "info depth " << depth 
-              << " score cp " << score 
-              << " nodes " << nodes 
-              << " time " << time;
-    
-    if (time > 0) {
-        std::cout << " nps " << (nodes * 1000 / time);
+void UCIProtocol::sendBestMove(const Move& move, const Move& ponderMove) {
+    std::string line = "bestmove " + move.toString();
+    if (!ponderMove.isNull()) {
+        line += " ponder " + ponderMove.toString();
+    }
+    send(line);
+}
+
+void UCIProtocol::sendInfo(const SearchInfo& info) {
+    std::ostringstream out;
+    out << "info depth " << info.depth << " seldepth " << info.selDepth;
+    
+    if (info.iterationComplete || info.bound != ScoreBound::EXACT) {
+        // Search scores are from white's point of view; UCI wants the mover's
+        bool whiteToMove = rootSideToMove == Color::WHITE;
+        int score = whiteToMove ? info.score : -info.score;
+        const int MATE_SCORE = 100000;
+        if (std::abs(score) >= MATE_SCORE - MAX_PLY) {
+            int plies = MATE_SCORE - std::abs(score);
+            int moves = (plies + 1) / 2;
+            out << " score mate " << (score > 0 ? moves : -moves);
+        } else {
+            out << " score cp " << score;
+        }
+
+        // Flipping the point of view swaps which side of the bound the score is on
+        if (info.bound == ScoreBound::LOWER) {
+            out << (whiteToMove ? " lowerbound" : " upperbound");
+        } else if (info.bound == ScoreBound::UPPER) {
+            out << (whiteToMove ? " upperbound" : " lowerbound");
+        }
     }
     
-    if (!pv.empty()) {
-        std::cout << " pv " << pv;
+    out << " nodes " << info.nodes
+        << " nps " << info.nps
+        << " hashfull " << info.hashfull
+        << " time " << info.timeMs;
+    
+    if (!info.pv.empty()) {
+        out << " pv";
+        for (const Move& move : info.pv) {
+            out << " " << move.toString();
+        }
     }
     
-    std::cout << std::endl;
-}
\ No newline at end of file
+    send(out.str());
+}
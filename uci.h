@@ -7,6 +7,11 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
 
 // UCI Option Types
 enum class UCIOptionType {
@@ -41,7 +46,17 @@ private:
     Engine& engine;
     std::map<std::string, UCIOption> options;
     bool debugMode;
-    bool searchActive;
+    std::atomic<bool> searchActive;
+
+    // Search runs on its own thread so stop/ponderhit/isready stay responsive
+    std::thread searchThread;
+    std::mutex outputMutex;             // One writer at a time on stdout
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool holdBestMove;                  // go infinite/ponder: wait for stop or ponderhit
+    int ponderTimeMs;                   // Budget to apply on ponderhit (0 = none)
+    Color rootSideToMove;               // For converting scores to the mover's view
+    std::chrono::steady_clock::time_point goStartTime;
     
     // UCI Command Handlers
     void handleUCI();
@@ -50,7 +65,9 @@ private:
     void handlePosition(const std::string& command);
     void handleGo(const std::string& command);
     void handleStop();
+    void handlePonderHit();
     void handleSetOption(const std::string& command);
+    void handleHashFile(bool save, const std::string& path);
     void handleQuit();
     
     // Helper Methods
@@ -59,11 +76,17 @@ private:
     void parsePosition(const std::string& positionStr);
     void parseGoCommand(const std::string& goStr);
     std::vector<std::string> split(const std::string& str, char delimiter);
-    void sendBestMove(const Move& move);
-    void sendInfo(int depth, int score, long nodes, int time, const std::string& pv);
+    void sendBestMove(const Move& move, const Move& ponderMove);
+    void sendInfo(const SearchInfo& info);
+    void send(const std::string& line);
+
+    // Search thread body, and a blocking stop-and-join of any running search
+    void searchWorker();
+    void stopSearch();
     
 public:
     UCIProtocol(Game& g, Engine& e);
+    ~UCIProtocol();
     
     // Main UCI Loop
     void run();
@@ -156,7 +156,7 @@ Move UI::getPlayerMove() const
     // Parse the move
     if (moveStr.length() < 4)
     {
-        return Move(Position(), Position());
+        return Move();
     }
 
     Position from = Position::fromString(moveStr.substr(0, 2));
@@ -164,7 +164,7 @@ Move UI::getPlayerMove() const
 
     if (!from.isValid() || !to.isValid())
     {
-        return Move(Position(), Position());
+        return Move();
     }
 
     // Check for promotion
@@ -428,8 +428,10 @@ bool UI::processCommand(const std::string &command)
                 int sizeMB = std::stoi(trimmedCommand.substr(7));
                 if (sizeMB > 0 && sizeMB <= 2048)
                 {
-                    engine.setTTSize(sizeMB);
-                    std::cout << "Transposition table size set to " << sizeMB << " MB" << std::endl;
+                    if (engine.setTTSize(sizeMB))
+                    {
+                        std::cout << "Transposition table size set to " << sizeMB << " MB" << std::endl;
+                    }
                 }
                 else
                 {
@@ -3,37 +3,84 @@
 
 #include "common.h"
 #include "piece.h"
+#include <array>
 
+// Zobrist keys are generated at compile time from a fixed seed, so a position
+// hashes to the same key in every process. That keeps TT dumps, opening books
+// and test logs comparable across runs.
+//
+// The board maintains its own key incrementally (see Board::getHashKey);
+// generateHashKey is the from-scratch version, mainly for verification.
 class Zobrist {
-private:
-    // Random keys for pieces at each position
-    // [piece_type][color][position]
-    uint64_t pieceKeys[6][2][64];
-    
-    // Random key for side to move (when it's black's turn)
-    uint64_t sideToMoveKey;
-    
-    // Random keys for castling rights
-    uint64_t castlingKeys[4]; // WK, WQ, BK, BQ
-    
-    // Random keys for en passant files
-    uint64_t enPassantKeys[8];
-    
-    // Has this been initialized?
-    bool initialized;
-    
 public:
-    // Constructor - initializes all random keys
-    Zobrist();
-    
-    // Initialize all random keys (called by constructor)
-    void initialize();
-    
-    // Generate a hash key for a given board position
-    uint64_t generateHashKey(const Board& board);
-    
-    // Update a hash key when making a move (faster than regenerating)
-    uint64_t updateHashKey(uint64_t currentKey, const Move& move, const Board& board);
+    // Seed of the key generator. Anything persisted with hash keys must record
+    // this value and reject data produced under a different one.
+    static const uint64_t SEED = 0x9E3779B97F4A7C15ULL;
+
+    // Key for a piece of the given color and type on a square (row * 8 + col)
+    static uint64_t pieceKey(Color color, PieceType type, int square) {
+        return keys().piece[color == Color::WHITE ? 0 : 1][static_cast<int>(type)][square];
+    }
+
+    // Key toggled whenever black is to move
+    static uint64_t sideToMoveKey() { return keys().sideToMove; }
+
+    // Combined key for a castling-rights mask (bit 0 = WK, 1 = WQ, 2 = BK, 3 = BQ)
+    static uint64_t castlingKey(int rights) { return keys().castling[rights & 15]; }
+
+    // Key for an en passant target on the given file
+    static uint64_t enPassantKey(int file) { return keys().enPassant[file]; }
+
+    // Generate a hash key for a given board position by scanning every square
+    static uint64_t generateHashKey(const Board& board);
+
+private:
+    struct KeyTable {
+        uint64_t piece[2][6][64];
+        uint64_t sideToMove;
+        uint64_t castling[16];
+        uint64_t enPassant[8];
+    };
+
+    // SplitMix64 step: good enough statistical quality for hash keys and
+    // trivially evaluable at compile time
+    static constexpr uint64_t splitMix(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    static constexpr KeyTable makeKeys() {
+        KeyTable table{};
+        uint64_t state = SEED;
+        for (int color = 0; color < 2; color++) {
+            for (int type = 0; type < 6; type++) {
+                for (int square = 0; square < 64; square++) {
+                    table.piece[color][type][square] = splitMix(state);
+                }
+            }
+        }
+        table.sideToMove = splitMix(state);
+
+        // One key per right; every mask is the XOR of the rights it contains
+        uint64_t rightKeys[4] = {splitMix(state), splitMix(state), splitMix(state), splitMix(state)};
+        for (int rights = 0; rights < 16; rights++) {
+            for (int bit = 0; bit < 4; bit++) {
+                if (rights & (1 << bit)) table.castling[rights] ^= rightKeys[bit];
+            }
+        }
+
+        for (int file = 0; file < 8; file++) {
+            table.enPassant[file] = splitMix(state);
+        }
+        return table;
+    }
+
+    static const KeyTable& keys() {
+        static constexpr KeyTable table = makeKeys();
+        return table;
+    }
 };
 
-#endif // ZOBRIST_H
\ No newline at end of file
+#endif // ZOBRIST_H